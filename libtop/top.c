@@ -11,12 +11,18 @@
 
 #include "gpon_libs_config.h"
 #include "top.h"
+#include "top_table.h"
 
+#include <limits.h>
 #include <sys/time.h>
-#include <signal.h>
 
 #ifdef LINUX
 #include <malloc.h>
+#include <unistd.h>
+#endif
+
+#ifdef ECOS
+#include <cyg/kernel/kapi.h>
 #endif
 
 #define opt(p) if (p) p
@@ -42,6 +48,16 @@ static inline struct top_page_state *active_page_state(struct top_context *ctx)
 	return &ctx->page_state[ctx->page_sel];
 }
 
+/** Check if the page data can be fetched */
+static inline int page_fetchable(const struct top_page_desc *page)
+{
+#ifdef LINUX
+	if (page->source)
+		return 1;
+#endif
+	return page->page_get != NULL;
+}
+
 /** Initialize groups
 
    \param init Where init or shutdown groups
@@ -88,35 +104,59 @@ static int is_filtered(struct top_context *ctx, const char *str)
 	return 1;
 }
 
-#ifdef LINUX
-static volatile sig_atomic_t g_need_shutdown = 0;
-
-/** shutdown handler
+/** Check if the parser may leave the filtered lines of the selected page
+    out of the line cache
 
-   \param[in] sig Signal
+   The full page is still needed if it is published or recorded.
 */
-static void shutdown(int sig)
+static bool filter_pushdown(struct top_context *ctx)
 {
-	if (sig == SIGSEGV)
-		fprintf(stderr, "Segmentation fault\n");
+	if (!ctx->filter[0] || active_page(ctx)->line_get != top_proc_line_get)
+		return false;
 
-	g_need_shutdown = 1;
-}
+#ifdef LINUX
+	if (ctx->shm ||
+	    (ctx->trigger && trigger_page_is_recorded(ctx, ctx->page_sel)))
+		return false;
 #endif
 
-#ifdef SIGWINCH
-/** resize indication */
-static volatile sig_atomic_t g_need_resize = 0;
+	return true;
+}
+
+#ifdef LINUX
+/** Split the selected page again after the filter changed
 
-/** resize handler
+   The lines are renumbered; the first line shown stays at its place in
+   the text.
 
-   \param[in] sig Signal
+   \param[in] pushdown Index only the lines matching the filter
 */
-static void resize(int sig)
+static void filter_reparse(struct top_context *ctx, bool pushdown)
 {
-	g_need_resize = 1;
+	struct top_page_state *state = active_page_state(ctx);
+	const char *start = NULL;
+	int line, total;
 
-	signal(sig, resize);
+	if (ctx->buff_page != ctx->page_sel ||
+	    (!ctx->parsed_filter && !pushdown))
+		return;
+
+	if (ctx->line_cache[0] && state->start < state->total)
+		start = ctx->line_cache[state->start];
+
+	ctx->fetch_filter = pushdown;
+	total = linux_text_refilter(ctx);
+	ctx->fetch_filter = false;
+	if (total < 0)
+		return;
+
+	/* the line cache is in text order */
+	for (line = 0; start && line < total; line++)
+		if (ctx->line_cache[line] >= start)
+			break;
+
+	state->total = total;
+	state->start = line;
 }
 #endif
 
@@ -131,110 +171,219 @@ static int activity_check(struct top_context *ctx, FILE *f)
 	return 0;
 }
 
-/** Fetch counters (update application's data with device's one)
+/** Get configured update interval of a page */
+static unsigned int interval_base(struct top_context *ctx,
+				  unsigned int page_idx)
+{
+	if (ctx->page[page_idx].interval)
+		return ctx->page[page_idx].interval;
+
+	return ctx->upd_delay;
+}
+
+/** Adapt update interval of a page after a fetch
+
+   Unchanged pages back off, changed pages go back towards the configured
+   interval; the fetch time limits the interval from below.
+
+   \param[in] ctx      context
+   \param[in] page_idx Fetched page
+   \param[in] us       Fetch time (in us)
+*/
+static void interval_update(struct top_context *ctx, unsigned int page_idx,
+			    uint64_t us)
+{
+	struct top_page_state *state = &ctx->page_state[page_idx];
+	unsigned int base = interval_base(ctx, page_idx);
+	unsigned int max = base > TOP_INTERVAL_MAX ? base : TOP_INTERVAL_MAX;
+	uint64_t interval = state->interval ? state->interval : base;
+	uint64_t min;
+
+	if (ctx->page[page_idx].interval) {
+		interval = base;
+	} else if (ctx->fetch_hash) {
+		if (ctx->fetch_hash == state->hash)
+			interval = interval * 2 < max ? interval * 2 : max;
+		else
+			interval = interval / 2 > base ? interval / 2 : base;
+
+		state->hash = ctx->fetch_hash;
+	}
+
+	if (ctx->fetch_share) {
+		/* us / interval_ms / 1000 <= fetch_share / 100 */
+		min = us / (10 * ctx->fetch_share);
+		if (interval < min)
+			interval = min < UINT_MAX ? min : UINT_MAX;
+	}
+
+	state->interval = (unsigned int)interval;
+}
 
-   \param[in] Counters group to fetch
+/** Get page data from the remote, the data source or the page handler
 
-   \return Number of lines in page; -1 if data fetch handler is
-           not defined
+   \return Number of lines in page
 */
-static int counters_fetch(struct top_context *ctx, unsigned int page_idx)
+static int page_fetch(struct top_context *ctx, unsigned int page_idx)
+{
+	int total = -1;
+
+#ifdef LINUX
+	if (ctx->remote)
+		total = remote_fetch(ctx, page_idx);
+
+	if (total < 0 && ctx->page[page_idx].source)
+		total = source_fetch(ctx, page_idx);
+	else
+#endif
+	if (total < 0)
+		total = ctx->page[page_idx].page_get(ctx,
+			ctx->page[page_idx].input_file_name);
+
+	return total;
+}
+
+int counters_fetch(struct top_context *ctx, unsigned int page_idx)
 {
-	if (!ctx->page[page_idx].page_get) {
+	int total = -1;
+	uint64_t start;
+
+	if (!page_fetchable(&ctx->page[page_idx])) {
 		ctx->page_state[page_idx].total = 0;
 		return -1;
 	}
 
-	ctx->page_state[page_idx].total = ctx->page[page_idx].page_get(ctx,
-		ctx->page[page_idx].input_file_name);
+	prof_fetch_start(ctx);
+	start = top_time_us();
+	ctx->fetch_hash = 0;
+	ctx->fetch_reused = false;
+	ctx->fetch_page = page_idx;
+	ctx->fetch_timed_out = false;
+
+#ifdef LINUX
+	/* a hung page must not hold up the others */
+	if (fetch_blocked(ctx, page_idx)) {
+		total = fetch_stale_get(ctx, page_idx);
+	} else {
+		total = page_fetch(ctx, page_idx);
+
+		fetch_done(ctx, page_idx, ctx->fetch_timed_out);
+		if (ctx->fetch_timed_out)
+			total = fetch_stale_get(ctx, page_idx);
+	}
+#else
+	total = page_fetch(ctx, page_idx);
+#endif
+
+	/* the shared buffer was filled without the parser */
+	if (!ctx->fetch_hash)
+		ctx->parsed_size = 0;
+
+	ctx->page_state[page_idx].total = total;
+	ctx->buff_page = page_idx;
+
+	start = top_time_us() - start;
+	prof_fetch_done(ctx, page_idx, start);
+
+	/* the wait for a late page isn't its fetch time, and older data
+	   doesn't tell whether the page changed */
+	if (!ctx->page_state[page_idx].stale)
+		interval_update(ctx, page_idx, start);
 
 	if (ctx->page_state[page_idx].start > ctx->page_state[page_idx].total)
 		ctx->page_state[page_idx].start = ctx->page_state[page_idx].total;
 
+#ifdef LINUX
+	/* older data was published already */
+	if (ctx->page_state[page_idx].stale)
+		return ctx->page_state[page_idx].total;
+
+	if (ctx->shm)
+		shm_publish(ctx, page_idx);
+
+	if (ctx->trigger)
+		trigger_fetch_done(ctx, page_idx);
+#endif
+
 	return ctx->page_state[page_idx].total;
 }
 
-/** Write table to file
+/** Write page as text
 
-   \param[in] out      File to write in
-   \param[in] page_idx Index of page
+   \return Number of bytes written
 */
-static void table_write(struct top_context *ctx, FILE *out, int page_idx)
+static uint64_t table_text_write(struct top_context *ctx, FILE *stream,
+				 int page_idx)
 {
-	int i;
+	int i, ret;
+	uint64_t written = 0;
 	char buff[TOP_LINE_LEN];
 	char *p;
 	top_do_fprintf_t *do_fprintf = ctx->ops->do_fprintf ?
 						ctx->ops->do_fprintf : fprintf;
-	FILE *stream = ctx->ops->stream ? ctx->ops->stream(ctx) : out;
 
-	if (!ctx->page[page_idx].line_get)
-		return;
-
-	do_fprintf(stream, "Page: %s" TOP_CRLF, ctx->page[page_idx].name);
+#ifdef LINUX
+	if (fetch_status_get(ctx, page_idx, buff, sizeof(buff)))
+		ret = do_fprintf(stream, "Page: %s (%s)" TOP_CRLF,
+				 ctx->page[page_idx].name, buff);
+	else
+#endif
+		ret = do_fprintf(stream, "Page: %s" TOP_CRLF,
+				 ctx->page[page_idx].name);
+	if (ret > 0)
+		written += ret;
 
 	buff[0] = 0;
 	p = ctx->page[page_idx].line_get(ctx, -1, buff);
 	if(p == NULL && buff[0] != 0)
 		p = buff;
-	if(p)
-		do_fprintf(stream, "%s" TOP_CRLF, p);
+	if(p) {
+		ret = do_fprintf(stream, "%s" TOP_CRLF, p);
+		if (ret > 0)
+			written += ret;
+	}
 
 	for (i = 0; i < ctx->page_state[page_idx].total; i++) {
 		buff[0] = 0;
 		p = ctx->page[page_idx].line_get(ctx, i, buff);
 		if(p == NULL && buff[0] != 0)
 			p = buff;
-		if(p)
-			do_fprintf(stream, "%s" TOP_CRLF, p);
+		if(p) {
+			ret = do_fprintf(stream, "%s" TOP_CRLF, p);
+			if (ret > 0)
+				written += ret;
+		}
 	}
+
+	return written;
 }
 
-static int readkey(struct top_context *ctx)
+/** Write table to file
+
+   \param[in] out      File to write in
+   \param[in] page_idx Index of page
+*/
+static void table_write(struct top_context *ctx, FILE *out, int page_idx)
 {
-	int c = ctx->ops->getch(ctx);
-	if (c == '\033') {
-		c = ctx->ops->getch(ctx);
-		if (c != '[')
-			return 0;
+	FILE *stream = ctx->ops->stream ? ctx->ops->stream(ctx) : out;
+	uint64_t start = top_time_us();
+	uint64_t written = 0;
 
-		c = ctx->ops->getch(ctx);
-
-		/* suitable for PuTTY default settings; need to fix if other
-		 * escape sequences are to be used */
-		switch (c) {
-		case 'A':
-			return KEY_UP;
-		case 'B':
-			return KEY_DOWN;
-		case 'C':
-			return KEY_RIGHT;
-		case 'D':
-			return KEY_LEFT;
-		case '1':
-			(void)ctx->ops->getch(ctx);
-			return KEY_HOME;
-		case '4':
-			(void)ctx->ops->getch(ctx);
-			return KEY_END;
-		case '5':
-			(void)ctx->ops->getch(ctx);
-			return KEY_PPAGE;
-		case '6':
-			(void)ctx->ops->getch(ctx);
-			return KEY_NPAGE;
-		default:
-			return 0;
-		}
-	}
+	if (!ctx->page[page_idx].line_get)
+		return;
 
-	return (int)c;
+	if (ctx->write_format != TOP_FORMAT_TEXT)
+		table_export(ctx, stream, page_idx);
+	else
+		written = table_text_write(ctx, stream, page_idx);
+
+	prof_frame_done(ctx, page_idx, 0, top_time_us() - start, written);
 }
 
 /** prompt line
 
    \param[in]     prefix Prompt prefix
-   \param[in,out] str    Return entered string
+   \param[in,out] str    Return entered string (TOP_LINE_LEN bytes)
 */
 static void prompt(struct top_context *ctx, const char *prefix, char *str)
 {
@@ -255,21 +404,25 @@ static void prompt(struct top_context *ctx, const char *prefix, char *str)
 		int len = strlen(str);
 		int key;
 
-		if (ctx->ops->pre_iter)
-			ret = ctx->ops->pre_iter(ctx);
+		/* pasted text is shown once it was entered as a whole */
+		if (!input_pending(ctx)) {
+			if (ctx->ops->pre_iter)
+				ret = ctx->ops->pre_iter(ctx);
 
-		ctx->ops->move(ctx, ctx->rows - 1, 0);
-		ctx->ops->addstr(ctx, prefix);
-		ctx->ops->addstr(ctx, str);
-		ctx->ops->clrtoeol(ctx);
-		opt(ctx->ops->refresh)(ctx);
+			ctx->ops->move(ctx, ctx->rows - 1, 0);
+			ctx->ops->addstr(ctx, prefix);
+			ctx->ops->addstr(ctx, str);
+			ctx->ops->clrtoeol(ctx);
+			opt(ctx->ops->refresh)(ctx);
+			screen_invalidate(ctx, ctx->rows - 1, 1);
 
-		if (ret == 0)
-			opt(ctx->ops->do_iter)(ctx);
+			if (ret == 0)
+				opt(ctx->ops->do_iter)(ctx);
 
-		opt(ctx->ops->post_iter)(ctx);
+			opt(ctx->ops->post_iter)(ctx);
+		}
 
-		key = readkey(ctx);
+		key = input_key(ctx);
 
 		switch (key) {
 		case KEY_CTRL_D:
@@ -283,7 +436,7 @@ static void prompt(struct top_context *ctx, const char *prefix, char *str)
 				str[--len] = 0;
 			break;
 		default:
-			if (key != 0) {
+			if (key != 0 && len < TOP_LINE_LEN - 1) {
 				if (((key >= '!') && (key <= '~')) ||
 				    (key == ' ')) {
 					str[len] = key;
@@ -306,20 +459,113 @@ static void prompt(struct top_context *ctx, const char *prefix, char *str)
 	opt(ctx->ops->post_iter)(ctx);
 }
 
-#ifdef LINUX
-/** Output information message
+/** Get number of terminal rows of a pane (header included) */
+static unsigned int pane_height(struct top_context *ctx, unsigned int pane)
+{
+	unsigned int height = (ctx->rows - 1) / ctx->pane_num;
+
+	/* the last pane gets the remaining rows */
+	if (pane == ctx->pane_num - 1)
+		return ctx->rows - 1 - height * (ctx->pane_num - 1);
+
+	return height;
+}
+
+/** Let the user pick one of the search results
 
-   \param[in] text Text to print
+   \param[in] result Search results
+   \param[in] num    Number of results
+
+   \return Index of the picked result; -1 if none was picked
 */
-static void notify(struct top_context *ctx, const char *text)
+static int search_pick(struct top_context *ctx,
+		       const struct top_search_result *result, int num)
 {
-	ctx->ops->move(ctx, ctx->rows - 1, 0);
-	ctx->ops->addstr(ctx, text);
-	ctx->ops->clrtoeol(ctx);
-	opt(ctx->ops->refresh)(ctx);
-	readkey(ctx);
+	const struct top_search_result *r;
+	const struct top_snapshot *snap;
+	char buff[TOP_LINE_LEN];
+	int rows = ctx->rows > 2 ? (int)ctx->rows - 2 : 1;
+	int sel = 0, first = 0, ret = 0, i;
+	size_t len = ctx->cols < sizeof(buff) ? ctx->cols : sizeof(buff);
+
+	for (;;) {
+		if (sel < first)
+			first = sel;
+		if (sel >= first + rows)
+			first = sel - rows + 1;
+
+		if (ctx->ops->pre_iter)
+			ret = ctx->ops->pre_iter(ctx);
+
+		snprintf(buff, len, "Search: %.900s (%d matches)",
+			 ctx->search_text, num);
+		ctx->ops->move(ctx, 0, 0);
+		opt(ctx->ops->attron)(ctx, A_UNDERLINE);
+		ctx->ops->addstr(ctx, buff);
+		ctx->ops->clrtoeol(ctx);
+		opt(ctx->ops->attroff)(ctx, A_UNDERLINE);
+
+		for (i = 0; i < rows; i++) {
+			ctx->ops->move(ctx, i + 1, 0);
+
+			if (first + i < num) {
+				r = &result[first + i];
+				snap = snapshot_cache_peek(ctx, r->page_idx);
+
+				/* one terminal row per result */
+				snprintf(buff, len, "%-16.16s %5d  %s",
+					 ctx->page[r->page_idx].name,
+					 r->line + 1, snap ?
+					 top_snapshot_line_get(snap, r->line) :
+					 "");
+
+				if (first + i == sel)
+					opt(ctx->ops->attron)(ctx, A_STANDOUT);
+				ctx->ops->addstr(ctx, buff);
+				if (first + i == sel)
+					opt(ctx->ops->attroff)(ctx, A_STANDOUT);
+			}
+
+			ctx->ops->clrtoeol(ctx);
+		}
+
+		ctx->ops->move(ctx, rows + 1, 0);
+		ctx->ops->addstr(ctx, "Up/Down to select, Enter to jump there");
+		ctx->ops->clrtoeol(ctx);
+		opt(ctx->ops->refresh)(ctx);
+
+		if (ret == 0)
+			opt(ctx->ops->do_iter)(ctx);
+
+		opt(ctx->ops->post_iter)(ctx);
+
+		switch (input_key(ctx)) {
+		case 0:
+			break;
+		case KEY_CTRL_Y:
+		case KEY_UP:
+			if (sel > 0)
+				sel--;
+			break;
+		case KEY_CTRL_E:
+		case KEY_DOWN:
+			if (sel < num - 1)
+				sel++;
+			break;
+		case KEY_ENTER:
+		case KEY_ENTER2:
+			return num ? sel : -1;
+		default:
+			return -1;
+		}
+	}
+}
+
+/** Get number of data lines shown for the selected page */
+static int view_rows(struct top_context *ctx)
+{
+	return (int)pane_height(ctx, ctx->pane_sel) - 1;
 }
-#endif /* #ifdef LINUX*/
 
 /** Get first line number */
 static int first_line_get(struct top_context *ctx)
@@ -419,7 +665,7 @@ static int next_page_get(struct top_context *ctx, int start)
 {
 	char buff[TOP_LINE_LEN];
 	int line;
-	int page_lines = ctx->rows - 2;
+	int page_lines = view_rows(ctx);
 
 	for (line = start + 1; line < active_page_state(ctx)->total - 1; line++) {
 		char *p = active_page(ctx)->line_get(ctx, line, buff);
@@ -447,7 +693,7 @@ static int prev_page_get(struct top_context *ctx, int start)
 {
 	char buff[TOP_LINE_LEN];
 	int line;
-	int page_lines = ctx->rows - 2;
+	int page_lines = view_rows(ctx);
 
 	for (line = start - 1; line > 0; line--) {
 		char *p = active_page(ctx)->line_get(ctx, line, buff);
@@ -467,36 +713,26 @@ static int prev_page_get(struct top_context *ctx, int start)
 	return -1;
 }
 
-static void dump_all_tables(struct top_context *ctx, const char *top_file)
+/** Write all pages
+
+   \return 0 on success; -1 if the activity check failed
+*/
+static int dump_all_tables(struct top_context *ctx, FILE *f)
 {
 	unsigned int i;
-	FILE *f;
-
-#ifdef LINUX
-	f = fopen(top_file, "w");
-	if (!f) {
-		fprintf(stderr, "Can't save dump to %s\n", top_file);
-		return;
-	}
-#else
-	f = stdout;
-#endif
 
 	for (i = 0; i < ctx->page_num; i++) {
 		if (activity_check(ctx, f))
-			break;
+			return -1;
 
 		if (counters_fetch(ctx, i) >= 0) {
 			table_write(ctx, f, i);
-			fprintf(f, "\n");
+			if (ctx->write_format == TOP_FORMAT_TEXT)
+				fprintf(f, "\n");
 		}
 	}
 
-#ifdef LINUX
-	fclose(f);
-	printf("Saved dump to %s\n", top_file);
-#endif
-
+	return 0;
 }
 
 /** Count cursor position in percents */
@@ -527,32 +763,28 @@ static void cnt_select(struct top_context *ctx, unsigned int net_page_sel)
 
 	ctx->page_sel = net_page_sel;
 
+	if (prev_sel_cnt_grp != net_page_sel)
+		prefetch_visit(ctx, prev_sel_cnt_grp);
+
 	if (is_cnt_selected(ctx) &&
 	    prev_sel_cnt_grp != net_page_sel &&
 	    ctx->page[net_page_sel].page_enter)
 		ctx->page[net_page_sel].page_enter(ctx);
 }
 
-#ifdef ECOS
-#define TICKS_PER_SEC 100
-static void gettimeofday(struct timeval *tv, int unused)
-{
-	cyg_tick_count_t ticks = cyg_current_time();
-
-	tv->tv_sec = ticks / TICKS_PER_SEC;
-	tv->tv_usec = (ticks % TICKS_PER_SEC) * 10 * 1000;
-}
-#endif
-
 #define NEED_REDRAW   (1 << 0)
 #define NEED_UPDATE   (1 << 1)
 #define NEED_SHUTDOWN (1 << 2)
+/** Periodic update; the screen is redrawn only if the page changed */
+#define NEED_TICK     (1 << 3)
+/** Terminal lags behind the last frame and the line rate allows to send */
+#define NEED_FLUSH    (1 << 4)
 
 /** Handle key and return true when we need to update page */
 static int ui_process_key(struct top_context *ctx, int key)
 {
-	int line;
-	static int group_key = 0;
+	struct top_search_result result[TOP_SEARCH_RESULT_MAX];
+	int line, num;
 #ifdef LINUX
 	char buff[TOP_LINE_LEN];
 	FILE *cnt_dump;
@@ -565,11 +797,14 @@ static int ui_process_key(struct top_context *ctx, int key)
 		break;
 
 	case KEY_ENTER:
-		group_key = 0;
+		ctx->group_key = 0;
 		break;
 
 	case '/':
 		prompt(ctx, "/", ctx->filter);
+#ifdef LINUX
+		filter_reparse(ctx, filter_pushdown(ctx));
+#endif
 
 		line = prev_line_get(ctx, active_page_state(ctx)->start);
 		if (line >= 0) {
@@ -588,7 +823,7 @@ static int ui_process_key(struct top_context *ctx, int key)
 		break;
 
 	case KEY_END:
-		line = last_line_get(ctx, ctx->rows - 2);
+		line = last_line_get(ctx, view_rows(ctx));
 		if (line >= 0 && active_page_state(ctx)->start != line)
 			active_page_state(ctx)->start = line;
 		break;
@@ -596,12 +831,87 @@ static int ui_process_key(struct top_context *ctx, int key)
 	case KEY_CTRL_X:
 		return NEED_SHUTDOWN;
 
+	case KEY_CTRL_V:
+		if (ctx->pane_num < TOP_PANE_MAX && ctx->pane_num < ctx->page_num &&
+		    (ctx->rows - 1) / (ctx->pane_num + 1) >= TOP_PANE_ROWS_MIN) {
+			/* new pane shows the page after the last one */
+			ctx->pane[ctx->pane_num] =
+				(ctx->pane[ctx->pane_num - 1] + 1) %
+				ctx->page_num;
+			ctx->pane_num++;
+		} else {
+			ctx->pane_num = 1;
+			ctx->pane_sel = 0;
+			ctx->pane[0] = ctx->page_sel;
+		}
+
+		ctx->clear_screen_on_update = 1;
+		return NEED_UPDATE | NEED_REDRAW;
+
+	case KEY_TAB:
+		if (ctx->pane_num < 2)
+			break;
+
+		ctx->pane_sel = (ctx->pane_sel + 1) % ctx->pane_num;
+		cnt_select(ctx, ctx->pane[ctx->pane_sel]);
+
+		/* the selected page has to be in the shared buffer */
+		return NEED_UPDATE | NEED_REDRAW;
+
+	case KEY_CTRL_P:
+		/* the first row shown, the filter may hide the start line */
+		for (line = active_page_state(ctx)->start;
+		     line < active_page_state(ctx)->total; line++) {
+			char text[TOP_LINE_LEN];
+			const char *p;
+
+			text[0] = 0;
+			p = active_page(ctx)->line_get(ctx, line, text);
+			if (!p)
+				p = text;
+
+			if (is_filtered(ctx, p))
+				continue;
+
+			if (watch_toggle(ctx, ctx->page_sel, line, p))
+				return 0;
+
+			return NEED_UPDATE | NEED_REDRAW;
+		}
+		break;
+
+	case KEY_CTRL_F:
+		prompt(ctx, "Search: ", ctx->search_text);
+		if (!ctx->search_text[0])
+			break;
+
+		ctx->ops->move(ctx, ctx->rows - 1, 0);
+		ctx->ops->addstr(ctx, "Searching all pages...");
+		ctx->ops->clrtoeol(ctx);
+		opt(ctx->ops->refresh)(ctx);
+		screen_invalidate(ctx, ctx->rows - 1, 1);
+
+		num = top_search(ctx, ctx->search_text, result,
+				 ARRAY_SIZE(result));
+		line = search_pick(ctx, result, num > 0 ? num : 0);
+		screen_invalidate(ctx, 0, ctx->rows);
+		if (line >= 0) {
+			cnt_select(ctx, result[line].page_idx);
+			/* the lines of the result are numbered unfiltered */
+			ctx->filter[0] = 0;
+			active_page_state(ctx)->start = result[line].line;
+		}
+
+		/* the page data was overwritten by the other pages */
+		ctx->clear_screen_on_update = 1;
+		return NEED_UPDATE | NEED_REDRAW;
+
 	case KEY_CTRL_E:
 	case KEY_DOWN:
 		line = next_line_get(ctx, active_page_state(ctx)->start);
 		if (line >= 0 && active_page_state(ctx)->start != line)
 			active_page_state(ctx)->start = line;
-		ctx->clear_screen_on_update = 1;
+		ctx->frame_scroll = true;
 
 		break;
 
@@ -610,7 +920,7 @@ static int ui_process_key(struct top_context *ctx, int key)
 		line = prev_line_get(ctx, active_page_state(ctx)->start);
 		if (line >= 0 && active_page_state(ctx)->start != line)
 			active_page_state(ctx)->start = line;
-		ctx->clear_screen_on_update = 1;
+		ctx->frame_scroll = true;
 
 		break;
 
@@ -636,64 +946,38 @@ static int ui_process_key(struct top_context *ctx, int key)
 
 #ifdef LINUX
 	case KEY_CTRL_W:
-		gettimeofday(&tv, 0);
-		sprintf(buff, "/tmp/%lld_%lld_%s.txt",
+		top_time_get(&tv);
+		sprintf(buff, "%lld_%lld_%s.txt",
 			(long long)tv.tv_sec, (long long)tv.tv_usec,
 			active_page(ctx)->name);
 
-		cnt_dump = fopen(buff, "w");
-		if (!cnt_dump) {
-			ctx->ops->clear(ctx);
-
-			sprintf(buff, "Can't save counters to "
-				"'/tmp/%lld_%lld_%s.txt'. "
-				"Press any key to continue...",
-				(long long)tv.tv_sec, (long long)tv.tv_usec,
-				active_page(ctx)->name);
-			notify(ctx, buff);
-
-			ctx->ops->clear(ctx);
+		/* the writer reports the result in the footer */
+		cnt_dump = writer_open(ctx, buff);
+		if (!cnt_dump)
 			break;
-		}
 
+		/* the dump holds the lines the filter pushdown left out */
+		filter_reparse(ctx, false);
 		table_write(ctx, cnt_dump, ctx->page_sel);
+		filter_reparse(ctx, filter_pushdown(ctx));
 
-		fclose(cnt_dump);
-
-		ctx->ops->clear(ctx);
-
-		sprintf(buff, "Saved to '/tmp/%lld_%lld_%s.txt'. "
-			"Press any key to continue...",
-			(long long)tv.tv_sec, (long long)tv.tv_usec,
-			active_page(ctx)->name);
-		notify(ctx, buff);
-
-		ctx->ops->clear(ctx);
+		writer_queue(ctx, cnt_dump);
 		break;
 
 	case KEY_CTRL_A:
-		gettimeofday(&tv, 0);
-		sprintf(buff, "/tmp/%lld_%lld.txt",
+		top_time_get(&tv);
+		sprintf(buff, "%lld_%lld.txt",
 			(long long)tv.tv_sec, (long long)tv.tv_usec);
 
-		ctx->ops->clear(ctx);
+		cnt_dump = writer_open(ctx, buff);
+		if (!cnt_dump)
+			break;
+
 		ctx->ops->move(ctx, ctx->rows - 1, 0);
 		ctx->ops->addstr(ctx, "Fetching all counters...");
+		ctx->ops->clrtoeol(ctx);
 		opt(ctx->ops->refresh)(ctx);
-
-		cnt_dump = fopen(buff, "w");
-		if (!cnt_dump) {
-			ctx->ops->clear(ctx);
-
-			sprintf(buff, "Can't save counters to "
-				"'/tmp/%lld_%lld.txt'. "
-				"Press any key to continue...",
-				(long long)tv.tv_sec, (long long)tv.tv_usec);
-			notify(ctx, buff);
-
-			ctx->ops->clear(ctx);
-			break;
-		}
+		screen_invalidate(ctx, ctx->rows - 1, 1);
 
 		for (i = 0; i < ctx->page_num; i++) {
 			if (activity_check(ctx, cnt_dump))
@@ -701,21 +985,15 @@ static int ui_process_key(struct top_context *ctx, int key)
 
 			if (counters_fetch(ctx, i) >= 0) {
 				table_write(ctx, cnt_dump, i);
-				fprintf(cnt_dump, "\n");
+				if (ctx->write_format == TOP_FORMAT_TEXT)
+					fprintf(cnt_dump, "\n");
 			}
 		}
 
-		fclose(cnt_dump);
-
-		ctx->ops->clear(ctx);
+		writer_queue(ctx, cnt_dump);
 
-		sprintf(buff, "Saved to '/tmp/%lld_%lld.txt'. "
-			"Press any key to continue...",
-			(long long)tv.tv_sec, (long long)tv.tv_usec);
-		notify(ctx, buff);
-
-		ctx->ops->clear(ctx);
-		break;
+		/* the page data was overwritten by the other pages */
+		return NEED_UPDATE | NEED_REDRAW;
 #endif
 
 	default:
@@ -726,9 +1004,9 @@ static int ui_process_key(struct top_context *ctx, int key)
 		}
 
 		for (i = 0; i < ctx->page_num; i++) {
-			if (group_key == ctx->page[i].group_key
+			if (ctx->group_key == ctx->page[i].group_key
 			    && key == ctx->page[i].key) {
-				group_key = 0;
+				ctx->group_key = 0;
 				cnt_select(ctx, i);
 
 				/* new page is selected, fetch it and redraw
@@ -738,15 +1016,15 @@ static int ui_process_key(struct top_context *ctx, int key)
 			}
 		}
 
-		if (!group_key) {
+		if (!ctx->group_key) {
 			for (i = 0; i < ctx->page_num; i++) {
 				if (ctx->page[i].group_key == key) {
-					group_key = key;
+					ctx->group_key = key;
 					break;
 				}
 			}
 		} else {
-			group_key = 0;
+			ctx->group_key = 0;
 		}
 
 		/* press key for unknown page, don't need to do anything */
@@ -758,21 +1036,253 @@ static int ui_process_key(struct top_context *ctx, int key)
 	return NEED_REDRAW;
 }
 
+/** Output string and account it in the frame profile; with a line rate
+    set, the frame is composed on the shadow screen, which accounts the
+    bytes it sends */
+static void ui_addstr(struct top_context *ctx, const char *s)
+{
+	if (ctx->screen) {
+		screen_addstr(ctx, s);
+		return;
+	}
+
+	ctx->prof.bytes_written += strlen(s);
+	ctx->ops->addstr(ctx, s);
+}
+
+static void ui_move(struct top_context *ctx, int y, int x)
+{
+	if (ctx->screen)
+		screen_move(ctx, y, x);
+	else
+		ctx->ops->move(ctx, y, x);
+}
+
+static void ui_clrtoeol(struct top_context *ctx)
+{
+	if (ctx->screen)
+		screen_clrtoeol(ctx);
+	else
+		ctx->ops->clrtoeol(ctx);
+}
+
+static void ui_attron(struct top_context *ctx, int attr)
+{
+	if (ctx->screen)
+		screen_attron(ctx, attr);
+	else
+		opt(ctx->ops->attron)(ctx, attr);
+}
+
+static void ui_attroff(struct top_context *ctx, int attr)
+{
+	if (ctx->screen)
+		screen_attroff(ctx, attr);
+	else
+		opt(ctx->ops->attroff)(ctx, attr);
+}
+
+/** Get line of a pane
+
+   \param[in]  page_idx Page
+   \param[in]  snap     Snapshot of the page; NULL to use the page data
+   \param[in]  line     Line number; -1 for header
+   \param[out] buff     Buffer for the line text
+
+   \return Line text; NULL if there is none
+*/
+static const char *pane_line_get(struct top_context *ctx,
+				 unsigned int page_idx,
+				 const struct top_snapshot *snap, int line,
+				 char *buff)
+{
+	const char *p;
+
+	if (snap)
+		return top_snapshot_line_get(snap, line);
+
+	buff[0] = 0;
+	p = ctx->page[page_idx].line_get(ctx, line, buff);
+	if (p == NULL && buff[0] != 0)
+		p = buff;
+
+	return p;
+}
+
+/** Draw page into a pane
+
+   \param[in] page_idx Page
+   \param[in] snap     Snapshot of the page; NULL to use the page data
+   \param[in] total    Number of lines of the page
+   \param[in] top      First terminal row of the pane
+   \param[in] height   Terminal rows of the pane
+   \param[in] focus    Pane is focused (marked if the screen is split)
+   \param[in] from     First terminal row to draw
+   \param[in] to       Row after the last one to draw; the rows outside
+                       already show the page
+
+   \return Time spent filtering (in us)
+*/
+static uint64_t pane_draw(struct top_context *ctx, unsigned int page_idx,
+			  const struct top_snapshot *snap, int total,
+			  unsigned int top, unsigned int height, bool focus,
+			  unsigned int from, unsigned int to)
+{
+	char buff[TOP_LINE_LEN];
+	uint64_t filter = 0, t;
+	int line, filtered;
+	const char *p;
+	unsigned int y, num;
+
+	if (to > top + height)
+		to = top + height;
+	if (from >= to)
+		return 0;
+
+	focus = focus && ctx->pane_num > 1;
+
+	if (from <= top) {
+		p = pane_line_get(ctx, page_idx, snap, -1, buff);
+		if (p == NULL || (snap && p[0] == 0))
+			p = ctx->page[page_idx].name;
+
+		ui_move(ctx, top, 0);
+		ui_attron(ctx, A_UNDERLINE);
+		if (focus)
+			ui_attron(ctx, A_STANDOUT);
+		ui_addstr(ctx, p);
+		ui_clrtoeol(ctx);
+		if (focus)
+			ui_attroff(ctx, A_STANDOUT);
+		ui_attroff(ctx, A_UNDERLINE);
+	}
+
+	/* data */
+	for (line = ctx->page_state[page_idx].start, y = top + 1;
+	     y < to;
+	     line++) {
+		if (line >= total) {
+			if (y >= from) {
+				ui_move(ctx, y, 0);
+				ui_clrtoeol(ctx);
+			}
+			y++;
+			continue;
+		}
+
+		p = pane_line_get(ctx, page_idx, snap, line, buff);
+		if (!p)
+			continue;
+
+		t = top_time_us();
+		filtered = is_filtered(ctx, p);
+		filter += top_time_us() - t;
+
+		if (filtered)
+			continue;
+
+		/* a wrapped line is drawn as a whole */
+		num = lines_num(ctx, p);
+		if (y + num > from) {
+			ui_move(ctx, y, 0);
+			ui_addstr(ctx, p);
+			ui_clrtoeol(ctx);
+		}
+		y += num;
+	}
+
+	return filter;
+}
+
+/** Get number of rows the cursor keys moved the selected page by since
+    the last frame
+
+   \param[in] height Terminal rows of the pane
+
+   \return Rows (negative if the page moved up); 0 if the page didn't move
+           or no row of the pane can be kept
+*/
+static int scroll_rows(struct top_context *ctx, unsigned int height)
+{
+	int from = ctx->frame_start, to = active_page_state(ctx)->start;
+	int first = from < to ? from : to, last = from < to ? to : from;
+	char buff[TOP_LINE_LEN];
+	int line, rows = 0;
+	const char *p;
+
+	for (line = first; line < last; line++) {
+		p = pane_line_get(ctx, ctx->page_sel, NULL, line, buff);
+		if (!p || is_filtered(ctx, p))
+			continue;
+
+		/* no row of the pane body is kept */
+		rows += lines_num(ctx, p);
+		if (rows >= (int)height - 1)
+			return 0;
+	}
+
+	return from < to ? rows : -rows;
+}
+
+/** Fetch the pages of the unfocused panes into the snapshot cache
+
+   \return true if any of them changed since it was drawn
+*/
+static bool panes_fetch(struct top_context *ctx)
+{
+	const struct top_snapshot *snap;
+	bool changed = false;
+	unsigned int i;
+
+	for (i = 0; i < ctx->pane_num; i++) {
+		if (i == ctx->pane_sel)
+			continue;
+
+		if (counters_fetch(ctx, ctx->pane[i]) < 0 ||
+		    snapshot_cache_update(ctx, ctx->pane[i]))
+			continue;
+
+		snap = snapshot_cache_peek(ctx, ctx->pane[i]);
+		if (snap && snap->gen != ctx->pane_gen[i])
+			changed = true;
+	}
+
+	return changed;
+}
+
 /** Fetch new page values (when NEED_UPDATE) and
  *  refresh screen (when NEED_REDRAW) */
 static void ui_redraw(struct top_context *ctx, int need)
 {
 	char buff[TOP_LINE_LEN];
+#ifdef LINUX
+	char status[TOP_LINE_LEN];
+#endif
+	unsigned int interval, i;
+	uint64_t drawn = ctx->frame_hash;
+	bool changed = false;
 
-#ifdef SIGWINCH
-	if (g_need_resize) {
-		ctx->ops->terminal_size_get(ctx);
+	if (ctx->need_resize) {
+		ctx->need_resize = 0;
+		ctx->frame_page = 0xFFFFFFFF;
 
-		g_need_resize = 0;
+		ctx->ops->terminal_size_get(ctx);
+		need |= NEED_REDRAW;
+
+		/* the panes have to keep a usable size */
+		while (ctx->pane_num > 1 &&
+		       (ctx->rows - 1) / ctx->pane_num < TOP_PANE_ROWS_MIN)
+			ctx->pane_num--;
+		if (ctx->pane_sel >= ctx->pane_num) {
+			ctx->pane_sel = ctx->pane_num - 1;
+			cnt_select(ctx, ctx->pane[ctx->pane_sel]);
+			need |= NEED_UPDATE;
+		}
 	}
-#endif
 
-	if (!active_page(ctx)->line_get || !active_page(ctx)->page_get) {
+	ctx->pane[ctx->pane_sel] = ctx->page_sel;
+
+	if (!active_page(ctx)->line_get || !page_fetchable(active_page(ctx))) {
 		fprintf(stderr, "ERROR: Can't retrieve "
 				"table data for %s; "
 				"no handler defined\n", active_page(ctx)->name);
@@ -782,99 +1292,237 @@ static void ui_redraw(struct top_context *ctx, int need)
 			if (activity_check(ctx, stderr))
 				return;
 
+			/* the shadow screen overwrites all changed cells */
 			if (ctx->clear_screen_on_update) {
-				ctx->ops->clear(ctx);
+				if (!ctx->screen)
+					ctx->ops->clear(ctx);
 				ctx->clear_screen_on_update = 0;
+				ctx->frame_page = 0xFFFFFFFF;
+			}
+
+#ifdef LINUX
+			/* recorded pages are fetched first as they overwrite
+			 * the data of the active page */
+			for (i = 0; ctx->trigger && i < ctx->page_num; i++)
+				if (i != ctx->page_sel &&
+				    trigger_page_is_recorded(ctx, i))
+					(void)counters_fetch(ctx, i);
+#endif
+
+			/* all panes are fetched back to back, the selected
+			 * page last as the key handling works on its data */
+			if (ctx->pane_num > 1)
+				changed = panes_fetch(ctx);
+
+			interval = top_page_interval_get(ctx, ctx->page_sel);
+
+			/* a prefetched page shows up without the fetch */
+			if (ctx->prefetch.switched &&
+			    prefetch_restore(ctx, ctx->page_sel, interval) >= 0)
+				ctx->prefetch.hits++;
+			else {
+				ctx->fetch_filter = filter_pushdown(ctx);
+				(void)counters_fetch(ctx, ctx->page_sel);
+				ctx->fetch_filter = false;
 			}
+			ctx->prefetch.switched = false;
+
+			/* the frame on the terminal still shows this text */
+			if ((need & NEED_TICK) && !(need & NEED_REDRAW) &&
+			    !changed &&
+			    ctx->fetch_hash && ctx->fetch_hash == ctx->frame_hash &&
+			    interval == top_page_interval_get(ctx, ctx->page_sel))
+				prof_frame_skipped(ctx, ctx->page_sel);
+			else
+				need |= NEED_REDRAW;
 
-			(void)counters_fetch(ctx, ctx->page_sel);
+			ctx->frame_hash = ctx->fetch_hash;
 		}
 	}
 
 	if (need & NEED_REDRAW) {
-		int line;
-		const char *p;
-		unsigned int y;
-
-		buff[0] = 0;
-		p = active_page(ctx)->line_get(ctx, -1, buff);
-		if (p == NULL) {
-			if (buff[0] == 0)
-				p = active_page(ctx)->name;
-			else
-				p = buff;
+		uint64_t start = top_time_us();
+		const struct top_snapshot *snap;
+		unsigned int top = 0, height, from, to;
+		uint64_t filter = 0, t;
+		bool reuse = false;
+		int rows = 0;
+
+		ctx->prof.bytes_written = 0;
+
+		/* the rows of the last frame are reused if only the cursor keys
+		 * moved the page */
+		if (ctx->frame_scroll && ctx->ops->scroll && !ctx->screen &&
+		    !ctx->clear_screen_on_update &&
+		    ctx->frame_page == ctx->page_sel &&
+		    ctx->frame_filter == top_hash(ctx->filter,
+						  strlen(ctx->filter)) &&
+		    (!(need & NEED_UPDATE) ||
+		     (drawn && drawn == ctx->fetch_hash))) {
+			rows = scroll_rows(ctx, pane_height(ctx, ctx->pane_sel));
+			reuse = rows ||
+				ctx->frame_start == active_page_state(ctx)->start;
 		}
 
-		ctx->ops->move(ctx, 0, 0);
-		opt(ctx->ops->attron)(ctx, A_UNDERLINE);
-		ctx->ops->addstr(ctx, p);
-		ctx->ops->clrtoeol(ctx);
-		opt(ctx->ops->attroff)(ctx, A_UNDERLINE);
+		/* the pane is drawn as a whole, the next update clears the
+		 * screen */
+		if (ctx->frame_scroll && !reuse)
+			ctx->clear_screen_on_update = 1;
 
-		/* data */
-		for (line = active_page_state(ctx)->start, y = 1;
-		     y + 1 < ctx->rows;
-		     line++) {
-			if (line >= active_page_state(ctx)->total) {
-				ctx->ops->move(ctx, y, 0);
-				ctx->ops->clrtoeol(ctx);
-				y++;
+		if (ctx->screen) {
+			for (i = 0; i < ctx->pane_sel; i++)
+				top += pane_height(ctx, i);
+
+			/* out of memory: draw the frames directly */
+			if (screen_begin(ctx, top,
+					 pane_height(ctx, ctx->pane_sel)))
+				screen_shutdown(ctx);
+			top = 0;
+		}
+
+		for (i = 0; i < ctx->pane_num; i++, top += height) {
+			height = pane_height(ctx, i);
+
+			if (i == ctx->pane_sel) {
+				from = top;
+				to = top + height;
+
+				/* DECSTBM scroll region below the header; only
+				 * the rows scrolled in are drawn */
+				if (rows)
+					ctx->ops->scroll(ctx, top + 1,
+							 top + height - 1, rows);
+				if (reuse && rows >= 0)
+					from = top + height - rows;
+				else if (reuse)
+					to = top + 1 - rows;
+
+				filter += pane_draw(ctx, ctx->page_sel, NULL,
+						    active_page_state(ctx)->total,
+						    top, height, true, from, to);
 				continue;
 			}
 
-			buff[0] = 0;
-			p = active_page(ctx)->line_get(ctx, line, buff);
-			if (p == NULL && buff[0] != 0)
-				p = buff;
-			if (p && is_filtered(ctx, p) == 0) {
-				ctx->ops->move(ctx, y, 0);
-				ctx->ops->addstr(ctx, p);
-				y += lines_num(ctx, p);
-				ctx->ops->clrtoeol(ctx);
-			}
+			snap = snapshot_cache_peek(ctx, ctx->pane[i]);
+			filter += pane_draw(ctx, ctx->pane[i], snap,
+					    snap ? snap->total : 0,
+					    top, height, false, top, top + height);
+			ctx->pane_gen[i] = snap ? snap->gen : 0;
 		}
 
 		/* footer */
-		ctx->ops->move(ctx, ctx->rows - 1, 0);
-		ctx->ops->clrtoeol(ctx);
-		ctx->ops->addstr(ctx, "Press ? or Ctrl-h for help");
-
 		sprintf(buff,
 			"%-30s                    Delay: %ums  %3d%%",
 			active_page(ctx)->name,
-			ctx->upd_delay,
+			top_page_interval_get(ctx, ctx->page_sel),
 			pos_percent(active_page_state(ctx)->start,
 				    active_page_state(ctx)->total));
 
-		ctx->ops->move(ctx, ctx->rows - 1,
-			       ctx->cols - (int)strlen(buff) - 1);
-		ctx->ops->addstr(ctx, buff);
+		ui_move(ctx, ctx->rows - 1, 0);
+		ui_clrtoeol(ctx);
+#ifdef LINUX
+		if (writer_status_get(ctx, status,
+				      ctx->cols > strlen(buff) + 2 ?
+				      ctx->cols - strlen(buff) - 2 : 1)) {
+			ui_addstr(ctx, status);
+			/* the status has to be removed again */
+			ctx->frame_hash = 0;
+		} else if (fetch_status_get(ctx, ctx->page_sel, status,
+					    sizeof(status))) {
+			ui_addstr(ctx, status);
+		} else
+#endif
+			ui_addstr(ctx, "Press ? or Ctrl-h for help");
 
+		ui_move(ctx, ctx->rows - 1, ctx->cols - (int)strlen(buff) - 1);
+		ui_addstr(ctx, buff);
+
+		if (ctx->screen)
+			(void)screen_flush(ctx);
+
+		opt(ctx->ops->refresh)(ctx);
+
+		ctx->frame_page = ctx->page_sel;
+		ctx->frame_start = active_page_state(ctx)->start;
+		ctx->frame_filter = top_hash(ctx->filter, strlen(ctx->filter));
+		ctx->frame_scroll = false;
+
+		t = top_time_us() - start;
+		prof_frame_done(ctx, ctx->page_sel, filter, t - filter,
+				ctx->prof.bytes_written);
+	} else if (need & NEED_FLUSH) {
+		(void)screen_flush(ctx);
 		opt(ctx->ops->refresh)(ctx);
 	}
 }
 
 static int top_ui_update_check(struct top_context *ctx, struct timeval *upd_time)
 {
+	unsigned int delay = top_page_interval_get(ctx, ctx->page_sel);
 	struct timeval tv;
+#ifdef LINUX
+	uint64_t now;
+
+	/* recorded pages still need the periodic update */
+	if (!ctx->trigger && source_notifies(ctx, ctx->page_sel)) {
+		now = top_time_ms();
+		if (now - active_page_state(ctx)->source_check <
+		    TOP_SOURCE_CHECK_DELAY)
+			return 0;
 
-	gettimeofday(&tv, 0);
+		active_page_state(ctx)->source_check = now;
+		if (!source_changed(ctx, ctx->page_sel))
+			return 0;
+
+		top_time_get(upd_time);
+		return NEED_UPDATE | NEED_TICK;
+	}
+#endif
 
-	if ((unsigned int)tv.tv_sec == upd_time->tv_sec + ctx->upd_delay / 1000) {
-		if ((unsigned int)tv.tv_usec - upd_time->tv_usec > ctx->upd_delay % 1000 * 1000) {
+	top_time_get(&tv);
+
+	if ((unsigned int)tv.tv_sec == upd_time->tv_sec + delay / 1000) {
+		if ((unsigned int)tv.tv_usec - upd_time->tv_usec > delay % 1000 * 1000) {
 			*upd_time = tv;
-			return NEED_UPDATE | NEED_REDRAW;
+			return NEED_UPDATE | NEED_TICK;
 		}
 	} else {
-		if ((unsigned int)tv.tv_sec - upd_time->tv_sec > ctx->upd_delay / 1000) {
+		if ((unsigned int)tv.tv_sec - upd_time->tv_sec > delay / 1000) {
 			*upd_time = tv;
-			return NEED_UPDATE | NEED_REDRAW;
+			return NEED_UPDATE | NEED_TICK;
 		}
 	}
 
 	return 0;
 }
 
+/** Get time (in ms) until the next update is due */
+static unsigned int top_ui_update_wait(struct top_context *ctx,
+				       const struct timeval *upd_time)
+{
+	unsigned int delay = top_page_interval_get(ctx, ctx->page_sel);
+	unsigned int wait;
+	struct timeval tv;
+	int64_t elapsed;
+
+#ifdef LINUX
+	if (!ctx->trigger && source_notifies(ctx, ctx->page_sel))
+		delay = TOP_SOURCE_CHECK_DELAY;
+#endif
+
+	top_time_get(&tv);
+	elapsed = ((int64_t)tv.tv_sec - upd_time->tv_sec) * 1000 +
+		  ((int64_t)tv.tv_usec - upd_time->tv_usec) / 1000;
+
+	if (elapsed < 0 || elapsed >= delay)
+		return 0;
+
+	/* the rest of the frame is sent as soon as the line rate allows */
+	wait = screen_wait(ctx);
+
+	return wait < delay - elapsed ? wait : delay - (unsigned int)elapsed;
+}
+
 /** Main window handler */
 void top_ui_main_loop(struct top_context *ctx)
 {
@@ -886,7 +1534,8 @@ void top_ui_main_loop(struct top_context *ctx)
 	if (!is_cnt_selected(ctx))
 		cnt_select(ctx, 0);
 
-	gettimeofday(&upd_time, 0);
+	top_time_get(&upd_time);
+	ctx->frame_scroll = false;
 
 	while (1) {
 		if (action) {
@@ -902,25 +1551,42 @@ void top_ui_main_loop(struct top_context *ctx)
 			opt(ctx->ops->post_iter)(ctx);
 		}
 
-		if (ctx->ops->hasch(ctx)) {
-			key = readkey(ctx);
+		ctx->key_wait = top_ui_update_wait(ctx, &upd_time);
+
+		if (input_pending(ctx) || ctx->ops->hasch(ctx)) {
+			key = input_key(ctx);
 
 			if (key == KEY_CTRL_C)
 				break;
 
 			action = ui_process_key(ctx, key);
+
+			/* the keys of a burst are processed before the next
+			 * frame */
+			while (!(action & NEED_SHUTDOWN) && input_pending(ctx)) {
+				key = input_key(ctx);
+				if (key == KEY_CTRL_C)
+					break;
+
+				action |= ui_process_key(ctx, key);
+			}
+
+			if (key == KEY_CTRL_C)
+				break;
 		} else {
 			action = 0;
 		}
 
 		if ((action & NEED_SHUTDOWN) || ctx->need_shutdown)
 			break;
-#ifdef LINUX
-		if (g_need_shutdown)
-			break;
-#endif
 
 		action |= top_ui_update_check(ctx, &upd_time);
+
+		if (!action && screen_pending(ctx))
+			action = NEED_FLUSH;
+
+		if (!action)
+			prefetch_step(ctx);
 	}
 }
 
@@ -936,6 +1602,7 @@ int top_init(struct top_context *ctx,
              top_custom_key_t *custom_key,
              void *priv)
 {
+	unsigned int i;
 
 	ctx->ops = ops;
 	ctx->priv = priv;
@@ -946,17 +1613,68 @@ int top_init(struct top_context *ctx,
 	ctx->page_init = page_init;
 	ctx->page_init_num = page_init_num;
 	ctx->page_sel = 0xFFFFFFFF;
+	ctx->pane_num = 1;
+	ctx->pane_sel = 0;
 	ctx->upd_delay = upd_delay;
+	ctx->fetch_share = TOP_FETCH_SHARE_DEFAULT;
+	ctx->fetch_hash = 0;
+	ctx->fetch_reused = false;
+	ctx->fetch_filter = false;
+	ctx->parsed_size = 0;
+	ctx->parsed_filter = 0;
+	ctx->frame_hash = 0;
+	ctx->frame_page = 0xFFFFFFFF;
+	ctx->frame_start = 0;
+	ctx->frame_filter = 0;
+	ctx->frame_scroll = false;
 	ctx->filter[0] = '\0';
 	ctx->need_shutdown = 0;
+	ctx->need_resize = 0;
+	ctx->group_key = 0;
+	ctx->key_wait = 0;
+#ifdef ECOS
+	ctx->console = NULL;
+#endif
 	ctx->activity_check = activity_check;
 	ctx->custom_key = custom_key;
+	ctx->trigger = NULL;
+	ctx->watch = NULL;
+	ctx->search = NULL;
+	ctx->screen = NULL;
+	ctx->search_text[0] = '\0';
+	ctx->batch_page = NULL;
+	ctx->batch_page_num = 0;
+	ctx->batch_count = 1;
+	ctx->batch_interval = 0;
+	ctx->fetch = NULL;
+	ctx->fetch_timeout = TOP_FETCH_TIMEOUT_DEFAULT;
+	ctx->buff_page = UINT_MAX;
+	strcpy(ctx->proc_root, TOP_PROC_ROOT_DEFAULT);
+	strcpy(ctx->dump_dir, TOP_DUMP_DIR_DEFAULT);
+	ctx->dump_fsync = TOP_FSYNC_NONE;
+	ctx->writer = NULL;
+	ctx->write_format = TOP_FORMAT_TEXT;
+	ctx->remote = NULL;
+	ctx->cache = NULL;
+	ctx->metrics = NULL;
+	ctx->shm = NULL;
 
 	ctx->page_state = malloc(sizeof(struct top_page_state) * page_num);
 	if (!ctx->page_state)
 		return -1;
 
 	memset(ctx->page_state, 0, sizeof(struct top_page_state) * page_num);
+	for (i = 0; i < page_num; i++)
+		ctx->page_state[i].source_fd = -1;
+
+	prefetch_init(ctx);
+	input_init(ctx);
+
+	if (prof_init(ctx)) {
+		free(ctx->page_state);
+		ctx->page_state = NULL;
+		return -1;
+	}
 
 	pages_init(ctx, true);
 
@@ -965,51 +1683,225 @@ int top_init(struct top_context *ctx,
 
 void top_shutdown(struct top_context *ctx)
 {
+	snapshot_cache_free(ctx);
+	prefetch_shutdown(ctx);
+	top_watch_shutdown(ctx);
+	search_shutdown(ctx);
+	screen_shutdown(ctx);
+	(void)top_batch_pages_set(ctx, NULL);
+#ifdef LINUX
+	fetch_shutdown(ctx);
+	top_trigger_shutdown(ctx);
+	top_remote_detach(ctx);
+	top_metrics_shutdown(ctx);
+	top_shm_publish_shutdown(ctx);
+	source_close(ctx);
+#endif
+	prof_shutdown(ctx);
 	free(ctx->page_state);
 	ctx->page_state = NULL;
 }
 
-void top_batch(struct top_context *ctx, const char *top_file)
+/** Write the selected page to stdout
+
+   \return 0 on success; -1 if the activity check failed
+*/
+static int batch_selected_write(struct top_context *ctx)
 {
-	if (is_cnt_selected(ctx)) {
-		int ret = 0;
+	int ret = 0;
 
-		if (ctx->page_sel >= ctx->page_num)
-			cnt_select(ctx, 0);
-		else
-			cnt_select(ctx, ctx->page_sel);
+	if (ctx->page_sel >= ctx->page_num)
+		cnt_select(ctx, 0);
+	else
+		cnt_select(ctx, ctx->page_sel);
 
-		if (activity_check(ctx, stderr))
+	if (activity_check(ctx, stderr))
+		return -1;
+
+	(void)counters_fetch(ctx, ctx->page_sel);
+
+	if (ctx->ops->pre_iter)
+		ret = ctx->ops->pre_iter(ctx);
+	if (ret == 0) {
+		table_write(ctx, stdout, ctx->page_sel);
+		opt(ctx->ops->do_iter)(ctx);
+	}
+	opt(ctx->ops->post_iter)(ctx);
+
+	return 0;
+}
+
+/** Write the pages of the batch list
+
+   \return 0 on success; -1 if the activity check failed
+*/
+static int batch_pages_write(struct top_context *ctx, FILE *f)
+{
+	unsigned int i;
+
+	for (i = 0; i < ctx->batch_page_num; i++) {
+		if (activity_check(ctx, f))
+			return -1;
+
+		/* pages may depend on their enter handler */
+		cnt_select(ctx, ctx->batch_page[i]);
+
+		if (counters_fetch(ctx, ctx->page_sel) >= 0) {
+			table_write(ctx, f, ctx->page_sel);
+			if (ctx->write_format == TOP_FORMAT_TEXT)
+				fprintf(f, "\n");
+		}
+	}
+
+	return 0;
+}
+
+/** Wait for the next batch sample
+
+   \param[in] ctx  Context
+   \param[in] next Start time (in ms) of the next sample
+
+   \return true if the batch mode was stopped meanwhile
+*/
+static bool batch_wait(struct top_context *ctx, uint64_t next)
+{
+	uint64_t now;
+
+	while (!ctx->need_shutdown && (now = top_time_ms()) < next) {
+		now = next - now < TOP_BATCH_WAIT_STEP ?
+		      next - now : TOP_BATCH_WAIT_STEP;
+#ifdef LINUX
+		usleep(now * 1000);
+#endif
+#ifdef ECOS
+		/* 10 ms ticks */
+		cyg_thread_delay(now / 10 ? now / 10 : 1);
+#endif
+	}
+
+	return ctx->need_shutdown;
+}
+
+void top_batch(struct top_context *ctx, const char *top_file)
+{
+	uint64_t next = top_time_ms();
+	FILE *f = stdout;
+	unsigned int i;
+
+#ifdef LINUX
+	/* all samples go into one file */
+	if ((ctx->batch_page_num || !is_cnt_selected(ctx)) && top_file) {
+		f = fopen(top_file, "w");
+		if (!f) {
+			fprintf(stderr, "Can't save dump to %s\n", top_file);
 			return;
+		}
+	}
+#endif
 
-		(void)counters_fetch(ctx, ctx->page_sel);
+	for (i = 0; !ctx->batch_count || i < ctx->batch_count; i++) {
+		if (i) {
+			/* a late sample doesn't shorten the next interval */
+			next += ctx->batch_interval;
+			if (next < top_time_ms())
+				next = top_time_ms();
 
-		if (ctx->ops->pre_iter)
-			ret = ctx->ops->pre_iter(ctx);
-		if (ret == 0) {
-			table_write(ctx, stdout, ctx->page_sel);
-			opt(ctx->ops->do_iter)(ctx);
+			if (batch_wait(ctx, next))
+				break;
 		}
-		opt(ctx->ops->post_iter)(ctx);
-	} else {
-		dump_all_tables(ctx, top_file);
+
+		if (ctx->batch_page_num) {
+			if (batch_pages_write(ctx, f))
+				break;
+		} else if (is_cnt_selected(ctx)) {
+			if (batch_selected_write(ctx))
+				break;
+		} else if (dump_all_tables(ctx, f)) {
+			break;
+		}
+
+		/* every sample reaches the reader right away */
+		fflush(f);
+	}
+
+	if (f != stdout) {
+		fclose(f);
+		if (!ctx->batch_page_num)
+			printf("Saved dump to %s\n", top_file);
 	}
 }
 
+int top_batch_pages_set(struct top_context *ctx, const char *list)
+{
+	char name[TOP_LINE_LEN];
+	unsigned int *page;
+	unsigned int num = 1;
+	const char *p;
+	size_t len;
+	int idx;
+
+	free(ctx->batch_page);
+	ctx->batch_page = NULL;
+	ctx->batch_page_num = 0;
+
+	if (!list)
+		return 0;
+
+	for (p = list; *p; p++)
+		if (*p == ',')
+			num++;
+
+	page = malloc(sizeof(*page) * num);
+	if (!page)
+		return -1;
+
+	for (p = list, num = 0; ; p += len + 1) {
+		len = strcspn(p, ",");
+		if (len >= sizeof(name)) {
+			free(page);
+			return -1;
+		}
+
+		memcpy(name, p, len);
+		name[len] = 0;
+
+		idx = top_page_find(ctx, name);
+		if (idx < 0) {
+			free(page);
+			return -1;
+		}
+		page[num++] = idx;
+
+		if (!p[len])
+			break;
+	}
+
+	ctx->batch_page = page;
+	ctx->batch_page_num = num;
+
+	return 0;
+}
+
+void top_batch_repeat_set(struct top_context *ctx, unsigned int count,
+			  unsigned int interval)
+{
+	ctx->batch_count = count;
+	ctx->batch_interval = interval;
+}
+
 void top_ui_prepare(struct top_context *ctx)
 {
 #ifdef LINUX
-	signal(SIGINT, shutdown);
-	signal(SIGSEGV, shutdown);
+	/* signals are not delivered if too many contexts are attached */
+	(void)top_signal_attach(ctx);
+
+	/* on failure dumps are written synchronously */
+	(void)writer_init(ctx);
 #endif
 	ctx->ops->terminal_size_get(ctx);
 
 	opt(ctx->ops->cbreak)(ctx);
 	opt(ctx->ops->curs_set)(ctx, 0);
-
-#ifdef SIGWINCH
-	signal(SIGWINCH, resize);
-#endif
 }
 
 void top_ui_shutdown(struct top_context *ctx)
@@ -1020,6 +1912,9 @@ void top_ui_shutdown(struct top_context *ctx)
 
 	opt(ctx->ops->endwin)(ctx);
 #ifdef LINUX
+	top_signal_detach(ctx);
+	writer_shutdown(ctx);
+
 	/* make sure the cursor for prompt is below last outputs */
 	printf("\n\n");
 #endif
@@ -1032,32 +1927,85 @@ void top_ui_stop(struct top_context *ctx)
 	ctx->need_shutdown = 1;
 }
 
-int top_select_group(struct top_context *ctx, const char *group)
+int top_page_find(struct top_context *ctx, const char *group)
 {
 	unsigned int u;
 
-	cnt_select(ctx, 0xFFFFFFFF);
 	for (u = 0; u < ctx->page_num; u++) {
 		if (strlen(group) == 1) {
 			if (ctx->page[u].group_key == 0
-			    && ctx->page[u].key == group[0]) {
-				cnt_select(ctx, u);
-				break;
-			}
+			    && ctx->page[u].key == group[0])
+				return u;
 		} else {
-			if (strcmp(ctx->page[u].name, group) == 0) {
-				cnt_select(ctx, u);
-				break;
-			}
+			if (strcmp(ctx->page[u].name, group) == 0)
+				return u;
 		}
 	}
 
+	return -1;
+}
+
+int top_select_group(struct top_context *ctx, const char *group)
+{
+	int idx;
+
+	cnt_select(ctx, 0xFFFFFFFF);
+
+	idx = top_page_find(ctx, group);
+	if (idx >= 0)
+		cnt_select(ctx, idx);
+
 	return is_cnt_selected(ctx);
 }
 
+void top_write_format_set(struct top_context *ctx, enum top_format format)
+{
+	ctx->write_format = format;
+}
+
+int top_write_format_parse(const char *name, enum top_format *format)
+{
+	static const char * const format_name[] = {
+		[TOP_FORMAT_TEXT] = "text",
+		[TOP_FORMAT_CSV] = "csv",
+		[TOP_FORMAT_NDJSON] = "ndjson",
+		[TOP_FORMAT_JSON] = "json",
+	};
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(format_name); i++) {
+		if (strcmp(name, format_name[i]) == 0) {
+			*format = i;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
 void top_upd_delay_set(struct top_context *ctx, unsigned int upd_delay)
 {
+	unsigned int i;
+
 	ctx->upd_delay = upd_delay;
+
+	/* learned intervals start over from the new delay */
+	for (i = 0; i < ctx->page_num; i++)
+		ctx->page_state[i].interval = 0;
+}
+
+void top_fetch_share_set(struct top_context *ctx, unsigned int percent)
+{
+	ctx->fetch_share = percent > 100 ? 100 : percent;
+}
+
+unsigned int top_page_interval_get(struct top_context *ctx,
+				   unsigned int page_idx)
+{
+	if (ctx->page_state[page_idx].interval)
+		return ctx->page_state[page_idx].interval;
+
+	return interval_base(ctx, page_idx);
 }
 
 #ifdef LINUX
@@ -15,6 +15,22 @@
 #include "top_config.h"
 #include "top_std_defs.h"
 #include "top_common.h"
+#include "top_snapshot.h"
+#include "top_trigger.h"
+#include "top_writer.h"
+#include "top_server.h"
+#include "top_metrics.h"
+#include "top_shm.h"
+#include "top_signal.h"
+#include "top_prof.h"
+#include "top_record.h"
+#include "top_source.h"
+#include "top_watch.h"
+#include "top_input.h"
+#include "top_prefetch.h"
+#include "top_fetch.h"
+#include "top_search.h"
+#include "top_screen.h"
 #ifdef LINUX
 #include "top_linux.h"
 #endif
@@ -27,6 +43,23 @@
 #define TOP_ROWS_DEFAULT 38
 #define TOP_COLS_DEFAULT 120
 
+/** Maximum number of panes of the split view */
+#define TOP_PANE_MAX 4
+
+/** Minimum number of terminal rows of a pane */
+#define TOP_PANE_ROWS_MIN 3
+
+/** Longest interval (in ms) an unchanged page backs off to, unless the
+    update delay is longer */
+#define TOP_INTERVAL_MAX 30000
+
+/** Default maximum share (in %) of time spent fetching a page */
+#define TOP_FETCH_SHARE_DEFAULT 10
+
+/** Longest sleep (in ms) between checks for a stop while batch mode waits
+    for the next sample */
+#define TOP_BATCH_WAIT_STEP 100
+
 struct top_context;
 
 /** Counters group initialization handler */
@@ -80,6 +113,13 @@ struct top_page_desc {
 
 	/* path to the profs file to be used */
 	const char* input_file_name;
+
+	/** Data source used instead of page_get; NULL if none */
+	const struct top_source *source;
+
+	/** Fixed update interval (in ms); 0 to adapt it to the content
+	    changes, starting from the update delay */
+	unsigned int interval;
 };
 
 /** "Ctrl-A" key definition */
@@ -103,6 +143,9 @@ struct top_page_desc {
 /** "Ctrl-H" key definition */
 #define KEY_CTRL_H 8
 
+/** "Ctrl-P" key definition */
+#define KEY_CTRL_P 16
+
 /** "Ctrl-R" key definition */
 #define KEY_CTRL_R 18
 
@@ -112,6 +155,9 @@ struct top_page_desc {
 /** "Ctrl-V" key definition */
 #define KEY_CTRL_V 22
 
+/** "Tab" key definition */
+#define KEY_TAB 9
+
 /** "Ctrl-W" key definition */
 #define KEY_CTRL_W 23
 
@@ -182,6 +228,14 @@ struct top_operations {
 
 	void (*refresh)(struct top_context *ctx);
 
+	/* scrolls rows top..bottom up by n rows (down if n is negative); the
+	   rows scrolled in are blank */
+	void (*scroll)(struct top_context *ctx, int top, int bottom, int n);
+
+	/* reads all available bytes at once (blocks for the first one)
+	   instead of getch; returns number of bytes, 0 at end of input */
+	int (*input)(struct top_context *ctx, char *buf, size_t size);
+
 	void (*cbreak)(struct top_context *ctx);
 	void (*endwin)(struct top_context *ctx);
 
@@ -196,12 +250,40 @@ typedef int (top_activity_check_t)(struct top_context *ctx, FILE *f);
 typedef int (top_custom_key_t)(struct top_context *ctx, const int key);
 typedef int (top_do_fprintf_t)(FILE *f, const char *fmt, ...);
 
+/** Output format of the table dumps */
+enum top_format {
+	/** Page text as shown on the screen */
+	TOP_FORMAT_TEXT,
+	/** Comma separated values, one header line per page */
+	TOP_FORMAT_CSV,
+	/** One JSON object per table row */
+	TOP_FORMAT_NDJSON,
+	/** One JSON document with column schema per page */
+	TOP_FORMAT_JSON
+};
+
 /** Runtime page state */
 struct top_page_state {
 	/** Start line, used for scrolling */
 	int start;
 	/** Total line number */
 	int total;
+	/** Open file of a notifying source; -1 if none */
+	int source_fd;
+	/** Last check (in ms) of the notifying source */
+	uint64_t source_check;
+	/** Effective update interval (in ms); 0 until the first fetch */
+	unsigned int interval;
+	/** Content hash of the last fetch; 0 if unknown */
+	uint64_t hash;
+	/** Last fetch timed out, the page shows older data */
+	bool stale;
+	/** Time of the last fetch in time; 0 if none */
+	struct timeval fresh_time;
+	/** Number of timeouts in a row */
+	unsigned int timeouts;
+	/** Time (monotonic, in ms) before which the page isn't fetched */
+	uint64_t backoff;
 };
 
 struct top_context {
@@ -228,8 +310,56 @@ struct top_context {
 	/** Pages state */
 	struct top_page_state *page_state;
 
+	/** Number of panes; 1 if the screen isn't split */
+	unsigned int pane_num;
+	/** Page shown in each pane */
+	unsigned int pane[TOP_PANE_MAX];
+	/** Focused pane; always shows the selected page */
+	unsigned int pane_sel;
+	/** Snapshot generation drawn in each pane */
+	uint32_t pane_gen[TOP_PANE_MAX];
+
 	/** Counters update delay (in ms) */
 	unsigned int upd_delay;
+	/** Maximum share (in %) of time spent fetching a page; 0 if
+	    unlimited */
+	unsigned int fetch_share;
+	/** Deadline (in ms) of the page file reads; 0 if none */
+	unsigned int fetch_timeout;
+	/** File read workers; NULL until the first read */
+	struct top_fetch *fetch;
+	/** Page of the running fetch */
+	unsigned int fetch_page;
+	/** Running fetch missed its deadline */
+	bool fetch_timed_out;
+	/** Page whose data is in the shared buffer; UINT_MAX if none */
+	unsigned int buff_page;
+	/** Hash of the text parsed by the running fetch; 0 if unknown */
+	uint64_t fetch_hash;
+	/** Running fetch reused the lines of the previous parse */
+	bool fetch_reused;
+	/** Running fetch may leave the lines not matching the filter out of
+	    the line cache */
+	bool fetch_filter;
+	/** Hash and size of the text the line cache was built from; size
+	    is 0 if the shared buffer was filled otherwise */
+	uint64_t parsed_hash;
+	size_t parsed_size;
+	/** End of the last line cut by the parser */
+	size_t parsed_end;
+	/** Number of lines of the parsed text */
+	int parsed_lines;
+	/** Hash of the filter the parser applied; 0 if it kept all lines */
+	uint64_t parsed_filter;
+	/** Hash of the page shown on the terminal; 0 if unknown */
+	uint64_t frame_hash;
+	/** Page, first line and filter hash of the last frame; the page is
+	    0xFFFFFFFF if the terminal doesn't show the frame */
+	unsigned int frame_page;
+	int frame_start;
+	uint64_t frame_filter;
+	/** Cursor keys moved the page by lines since the last frame */
+	bool frame_scroll;
 
 	/** Filter string */
 	char filter[TOP_LINE_LEN];
@@ -240,10 +370,73 @@ struct top_context {
 
 	/** Request main loop shutdown */
 	volatile int need_shutdown;
+	/** Terminal size changed */
+	volatile int need_resize;
+	/** Group key pressed before the page key; 0 if none */
+	int group_key;
+	/** Time (in ms) hasch may wait for a key; the main loop is idle
+	    until then */
+	unsigned int key_wait;
+#ifdef LINUX
+	/** Terminal settings before switching to non-canonical mode */
+	struct termios orig_opts;
+#endif
+#ifdef ECOS
+	/** Serial console input; NULL until the first key is read */
+	struct ecos_console *console;
+#endif
 
 	top_activity_check_t *activity_check;
 	top_custom_key_t *custom_key;
 
+	/** Pinned rows of the watch page; NULL if none were pinned */
+	struct top_watch *watch;
+
+	/** Search indexes of the pages; NULL until the first search */
+	struct top_search *search;
+	/** Text of the last search */
+	char search_text[TOP_LINE_LEN];
+
+	/** Shadow screen; NULL if the line rate is unlimited */
+	struct top_screen *screen;
+
+	/** Pages written by batch mode; NULL for the default */
+	unsigned int *batch_page;
+	unsigned int batch_page_num;
+	/** Number of batch samples; 0 until stopped */
+	unsigned int batch_count;
+	/** Time (in ms) between the batch samples */
+	unsigned int batch_interval;
+
+	/** Trigger engine; NULL if disabled */
+	struct top_trigger *trigger;
+
+	/** Root of the procfs tree the pages are read from */
+	char proc_root[TOP_PROC_ROOT_LEN];
+
+	/** Directory for the counter dumps */
+	char dump_dir[TOP_DUMP_DIR_LEN];
+	/** Flush policy for the counter dumps */
+	enum top_fsync_policy dump_fsync;
+	/** Dump writer thread; NULL if dumps are written synchronously */
+	struct top_writer *writer;
+	/** Output format of the table dumps */
+	enum top_format write_format;
+	/** Snapshot server connection; NULL if pages are read locally */
+	struct top_remote *remote;
+	/** Latest snapshot of each page; NULL until first capture */
+	struct top_snapshot *cache;
+	/** Metrics endpoint; NULL if disabled */
+	struct top_metrics *metrics;
+	/** Shared memory publication; NULL if disabled */
+	struct top_shm *shm;
+	/** Prefetch of the likely next pages into the snapshot cache */
+	struct top_prefetch prefetch;
+	/** Terminal input decoder and queue of keys not processed yet */
+	struct top_input input;
+	/** Fetch, parse, filter and render profile */
+	struct top_prof prof;
+
 	void *priv;
 };
 
@@ -263,9 +456,37 @@ int top_init(struct top_context *ctx,
 /** Shutdown top */
 void top_shutdown(struct top_context *ctx);
 
-/** Run top in batch mode */
+/** Run top in batch mode
+
+   Writes the pages set by \ref top_batch_pages_set to top_file (stdout if
+   it is NULL), else the selected page to stdout, else all pages to
+   top_file. See \ref top_batch_repeat_set for repeated samples.
+*/
 void top_batch(struct top_context *ctx, const char *top_file);
 
+/** Set pages written by batch mode
+
+   The pages are fetched one after another and written in the given order,
+   each sample in a single pass.
+
+   \param[in] ctx  Context
+   \param[in] list Comma separated page keys or names, as accepted by
+                   top_select_group; NULL to write the selected or all pages
+
+   \return 0 on success; -1 if a page is unknown
+*/
+int top_batch_pages_set(struct top_context *ctx, const char *list);
+
+/** Repeat the batch mode output
+
+   \param[in] ctx      Context
+   \param[in] count    Number of samples; 0 to sample until top_ui_stop
+                       (or a termination signal)
+   \param[in] interval Time (in ms) between the starts of the samples
+*/
+void top_batch_repeat_set(struct top_context *ctx, unsigned int count,
+			  unsigned int interval);
+
 /** Prepare UI (switch to non-canonical mode) */
 void top_ui_prepare(struct top_context *ctx);
 /** Start main loop */
@@ -278,9 +499,41 @@ void top_ui_stop(struct top_context *ctx);
 /** Select page by name */
 int top_select_group(struct top_context *ctx, const char *group);
 
+/** Find page by key or name
+
+   \return Page index; -1 if not found
+*/
+int top_page_find(struct top_context *ctx, const char *group);
+
+/** Configure output format of the table dumps */
+void top_write_format_set(struct top_context *ctx, enum top_format format);
+
+/** Get output format by name ("text", "csv", "ndjson" or "json")
+
+   \return 0 on success; -1 if the name is unknown
+*/
+int top_write_format_parse(const char *name, enum top_format *format);
+
 /** Configure update time */
 void top_upd_delay_set(struct top_context *ctx, unsigned int upd_delay);
 
+/** Limit the share of time spent fetching a page
+
+   Pages whose fetch takes longer than percent of their interval are
+   fetched less often.
+
+   \param[in] ctx     Context
+   \param[in] percent Maximum share (1..100); 0 for no limit
+*/
+void top_fetch_share_set(struct top_context *ctx, unsigned int percent);
+
+/** Get effective update interval of a page
+
+   \return Interval (in ms)
+*/
+unsigned int top_page_interval_get(struct top_context *ctx,
+				   unsigned int page_idx);
+
 /** Print available pages to stdout */
 void top_print_groups(struct top_context *ctx);
 
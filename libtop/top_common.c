@@ -14,6 +14,148 @@
 
 #include <sys/time.h>
 #include <sys/ioctl.h>
+#include <time.h>
+
+#ifdef ECOS
+#define TICKS_PER_SEC 100
+#endif
+
+void top_time_get(struct timeval *tv)
+{
+#ifdef ECOS
+	cyg_tick_count_t ticks = cyg_current_time();
+
+	tv->tv_sec = ticks / TICKS_PER_SEC;
+	tv->tv_usec = (ticks % TICKS_PER_SEC) * 10 * 1000;
+#else
+	gettimeofday(tv, 0);
+#endif
+}
+
+uint64_t top_time_ms(void)
+{
+#ifdef ECOS
+	return (uint64_t)cyg_current_time() * 1000 / TICKS_PER_SEC;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+#define HASH_P1 0x9e3779b185ebca87ULL
+#define HASH_P2 0xc2b2ae3d27d4eb4fULL
+#define HASH_P3 0x165667b19e3779f9ULL
+#define HASH_P4 0x85ebca77c2b2ae63ULL
+#define HASH_P5 0x27d4eb2f165667c5ULL
+
+static inline uint64_t hash_rotl(uint64_t x, unsigned int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t hash_round(uint64_t acc, uint64_t input)
+{
+	acc += input * HASH_P2;
+	acc = hash_rotl(acc, 31);
+
+	return acc * HASH_P1;
+}
+
+static inline uint64_t hash_merge(uint64_t acc, uint64_t val)
+{
+	acc ^= hash_round(0, val);
+
+	return acc * HASH_P1 + HASH_P4;
+}
+
+static inline uint64_t hash_read64(const unsigned char *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof(v));
+
+	return v;
+}
+
+static inline uint32_t hash_read32(const unsigned char *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+
+	return v;
+}
+
+uint64_t top_hash(const void *data, size_t len)
+{
+	const unsigned char *p = data;
+	const unsigned char *end = p + len;
+	uint64_t v1, v2, v3, v4, hash;
+
+	/* XXH64 with seed 0; words are read in host byte order */
+	if (len >= 32) {
+		v1 = HASH_P1 + HASH_P2;
+		v2 = HASH_P2;
+		v3 = 0;
+		v4 = -HASH_P1;
+
+		do {
+			v1 = hash_round(v1, hash_read64(p));
+			v2 = hash_round(v2, hash_read64(p + 8));
+			v3 = hash_round(v3, hash_read64(p + 16));
+			v4 = hash_round(v4, hash_read64(p + 24));
+			p += 32;
+		} while (end - p >= 32);
+
+		hash = hash_rotl(v1, 1) + hash_rotl(v2, 7) +
+		       hash_rotl(v3, 12) + hash_rotl(v4, 18);
+		hash = hash_merge(hash, v1);
+		hash = hash_merge(hash, v2);
+		hash = hash_merge(hash, v3);
+		hash = hash_merge(hash, v4);
+	} else {
+		hash = HASH_P5;
+	}
+
+	hash += len;
+
+	for (; end - p >= 8; p += 8) {
+		hash ^= hash_round(0, hash_read64(p));
+		hash = hash_rotl(hash, 27) * HASH_P1 + HASH_P4;
+	}
+
+	if (end - p >= 4) {
+		hash ^= (uint64_t)hash_read32(p) * HASH_P1;
+		hash = hash_rotl(hash, 23) * HASH_P2 + HASH_P3;
+		p += 4;
+	}
+
+	for (; p < end; p++) {
+		hash ^= *p * HASH_P5;
+		hash = hash_rotl(hash, 11) * HASH_P1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= HASH_P2;
+	hash ^= hash >> 29;
+	hash *= HASH_P3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+int top_proc_root_set(struct top_context *ctx, const char *root)
+{
+	if (strlen(root) >= sizeof(ctx->proc_root))
+		return -1;
+
+	strcpy(ctx->proc_root, root);
+
+	return 0;
+}
 
 int help_get(struct top_context *ctx, const char *dummy)
 {
@@ -29,12 +171,17 @@ int help_get(struct top_context *ctx, const char *dummy)
 		"End             Jump to last line",
 		" /               Define filter                 "
 		"Enter           Drop group key",
+		" Ctrl-v          Split off next page (up to 4) "
+		"Tab             Next pane",
+		" Ctrl-p          Pin top row to the watch page "
+		"(unpin it there)",
+		" Ctrl-f          Search all pages",
 		" ",
 #ifdef LINUX
 		" Ctrl-w          Write selected (current page) "
-		"counters to file /tmp/<Date>_<Time>_<Group>.txt",
+		"counters to file <Dir>/<Date>_<Time>_<Group>.txt",
 		" Ctrl-a          Dump all pages to file "
-		"/tmp/<Date>_<Time>.txt",
+		"<Dir>/<Date>_<Time>.txt",
 		"",
 #endif
 		" Ctrl-x, Ctrl-c  Exit program",
@@ -61,6 +208,99 @@ int help_get(struct top_context *ctx, const char *dummy)
 		+ ctx->page_num % 2;
 }
 
+/** Render percentiles of a histogram */
+static void prof_hist_render(char *buff, size_t size,
+			     const struct top_hist *hist)
+{
+	snprintf(buff, size, "%u/%u", top_hist_percentile(hist, 50),
+		 top_hist_percentile(hist, 99));
+}
+
+int prof_get(struct top_context *ctx, const char *dummy)
+{
+	static const char * const phase_name[TOP_PROF_PHASE_NUM] = {
+		"fetch", "parse", "filter", "render"
+	};
+	const struct top_prof_page *pp;
+	char hist[TOP_PROF_PHASE_NUM][24];
+	unsigned int i, k, n = 0, b;
+	int len;
+
+	ctx->line_cache[0] = NULL;
+
+	if (!ctx->prof.page)
+		return 0;
+
+	snprintf(ctx->shared_buff[n++], TOP_LINE_LEN,
+		 "%-20s %8s %13s %13s %13s %13s %8s %8s %9s %8s %8s",
+		 "Page", "Fetches", "Fetch us", "Parse us", "Filter us",
+		 "Render us", "Read B", "Syscalls", "Written B",
+		 "Unparsed", "Unshown");
+
+	for (i = 0; i < ctx->page_num && n < TOP_LINE_MAX; i++) {
+		pp = &ctx->prof.page[i];
+		if (!pp->fetches && !pp->frames)
+			continue;
+
+		for (k = 0; k < TOP_PROF_PHASE_NUM; k++)
+			prof_hist_render(hist[k], sizeof(hist[k]),
+					 &pp->hist[k]);
+
+		/* I/O counts are per fetch, output per frame */
+		snprintf(ctx->shared_buff[n++], TOP_LINE_LEN,
+			 "%-20.20s %8llu %13s %13s %13s %13s %8llu %8llu %9llu "
+			 "%8llu %8llu",
+			 ctx->page[i].name,
+			 (unsigned long long)pp->fetches,
+			 hist[TOP_PROF_FETCH], hist[TOP_PROF_PARSE],
+			 hist[TOP_PROF_FILTER], hist[TOP_PROF_RENDER],
+			 (unsigned long long)(pp->fetches ?
+					pp->bytes_read / pp->fetches : 0),
+			 (unsigned long long)(pp->fetches ?
+					pp->syscalls / pp->fetches : 0),
+			 (unsigned long long)(pp->frames ?
+					pp->bytes_written / pp->frames : 0),
+			 (unsigned long long)pp->parse_skips,
+			 (unsigned long long)pp->frame_skips);
+	}
+
+	/* latency distribution of the page shown before */
+	pp = &ctx->prof.page[ctx->prof.last];
+	if (n + 2 + TOP_PROF_PHASE_NUM > TOP_LINE_MAX ||
+	    ctx->page[ctx->prof.last].page_get == prof_get ||
+	    (!pp->fetches && !pp->frames))
+		return n;
+
+	ctx->shared_buff[n++][0] = 0;
+	snprintf(ctx->shared_buff[n++], TOP_LINE_LEN,
+		 "Latency of %s (us, log2 buckets):",
+		 ctx->page[ctx->prof.last].name);
+
+	for (k = 0; k < TOP_PROF_PHASE_NUM; k++) {
+		len = snprintf(ctx->shared_buff[n], TOP_LINE_LEN, "%-7s",
+			       phase_name[k]);
+
+		for (b = 0; b < TOP_PROF_BUCKETS && len < TOP_LINE_LEN; b++) {
+			if (!pp->hist[k].bucket[b])
+				continue;
+
+			if (b < TOP_PROF_BUCKETS - 1)
+				len += snprintf(ctx->shared_buff[n] + len,
+						TOP_LINE_LEN - len,
+						" <%lu:%u", 1UL << b,
+						pp->hist[k].bucket[b]);
+			else
+				len += snprintf(ctx->shared_buff[n] + len,
+						TOP_LINE_LEN - len,
+						" >=%lu:%u", 1UL << (b - 1),
+						pp->hist[k].bucket[b]);
+		}
+		n++;
+	}
+
+	return n;
+}
+
 void help_entry_render(struct top_context *ctx,
 		       char *buff, int group1, int group2)
 {
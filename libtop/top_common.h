@@ -24,18 +24,61 @@
 /** Proc counters */
 #if defined(LINUX) || defined(ECOS)
 #define ONU_CNT_PROC(key1, key2, name, proc_entry) \
-{ key1, key2, name, top_proc_line_get, onu_top_proc_get, NULL, NULL, proc_entry },
+{ key1, key2, name, top_proc_line_get, onu_top_proc_get, NULL, NULL, \
+  proc_entry, NULL, 0 },
 #define OPTIC_CNT_PROC(key1, key2, name, proc_entry) \
-{ key1, key2, name, top_proc_line_get, optic_top_proc_get, NULL, NULL, proc_entry },
+{ key1, key2, name, top_proc_line_get, optic_top_proc_get, NULL, NULL, \
+  proc_entry, NULL, 0 },
 #else
 #define CNT_PROC(key1, key2, name, proc_entry)
 #endif
 
+/** Counters from a data source (see top_source.h) */
+#define CNT_SOURCE(key1, key2, name, source) \
+{ key1, key2, name, top_proc_line_get, NULL, NULL, NULL, NULL, source, 0 },
+
+/** Watch page showing the pinned rows (see top_watch.h) */
+#define CNT_WATCH(key1, key2, name) \
+{ key1, key2, name, top_proc_line_get, watch_get, NULL, NULL, NULL, NULL, \
+  TOP_WATCH_INTERVAL },
+
 /** Regular counters */
 #define CNT(key1, key2, name, line_get, page_get, on_enter, on_leave) \
-{ key1, key2, name, line_get, page_get, on_enter, on_leave, NULL },
+{ key1, key2, name, line_get, page_get, on_enter, on_leave, NULL, NULL, 0 },
 
 struct top_context;
+struct timeval;
+
+/** Get current wall clock time
+
+   \param[out] tv  Current time
+*/
+void top_time_get(struct timeval *tv);
+
+/** Get monotonic time
+
+   \return Time in ms
+*/
+uint64_t top_time_ms(void);
+
+/** Calculate hash of a buffer
+
+   \param[in] data Buffer
+   \param[in] len  Buffer length
+
+   \return Hash value
+*/
+uint64_t top_hash(const void *data, size_t len);
+
+/** Fetch counters (update application's data with device's one)
+
+   \param[in] ctx      context
+   \param[in] page_idx Counters group to fetch
+
+   \return Number of lines in page; -1 if data fetch handler is
+           not defined
+*/
+int counters_fetch(struct top_context *ctx, unsigned int page_idx);
 
 /** Read file contents into shared buffer from procfs.
 
@@ -46,6 +89,48 @@ struct top_context;
 */
 int linux_file_read(struct top_context *ctx, const char *name);
 
+/** Read from file descriptor into shared buffer until EOF
+
+   \param[in] ctx   context
+   \param[in] fd    File descriptor, read from its current offset
+
+   \return Number of bytes read
+*/
+size_t linux_fd_read(struct top_context *ctx, int fd);
+
+/** Split text in shared buffer into lines
+
+   \param[in] ctx   context
+   \param[in] size  Text size
+
+   \return Number of lines
+*/
+int linux_text_parse(struct top_context *ctx, size_t size);
+
+/** Split the last parsed text again, e.g. for a changed filter
+
+   The lines the filter of the last parse left out are still in the shared
+   buffer.
+
+   \param[in] ctx   context
+
+   \return Number of lines; -1 if the shared buffer doesn't hold the parsed
+           text anymore
+*/
+int linux_text_refilter(struct top_context *ctx);
+
+/** Get path of the file a page is read from
+
+   \param[in]  ctx      context
+   \param[in]  page_idx Page
+   \param[out] path     Path of the file
+   \param[in]  size     Size of path
+
+   \return 0 on success; -1 if the page isn't read from a file
+*/
+int linux_page_path(struct top_context *ctx, unsigned int page_idx,
+		    char *path, size_t size);
+
 /** Read file contents into shared buffer from emulated procfs.
 
    \param[in] ctx   context
@@ -55,6 +140,21 @@ int linux_file_read(struct top_context *ctx, const char *name);
 */
 int ecos_file_read(struct top_context *ctx, const char *name, const bool onu);
 
+/** Default root of the procfs tree */
+#define TOP_PROC_ROOT_DEFAULT "/proc"
+
+/** Maximum length of the procfs root path */
+#define TOP_PROC_ROOT_LEN 128
+
+/** Set root of the procfs tree (e.g. a directory with synthetic tables)
+
+   \param[in] ctx  context
+   \param[in] root Directory which replaces /proc
+
+   \return 0 on success; -1 if the path is too long
+*/
+int top_proc_root_set(struct top_context *ctx, const char *root);
+
 /** read file from procfs
 
    \return Number of lines in the file
@@ -76,6 +176,13 @@ char *top_proc_line_get(struct top_context *ctx, const int line, char *text);
 
 int help_get(struct top_context *ctx, const char *dummy);
 
+/** Render profile of all pages (fetch, parse, filter and render latency
+    percentiles, I/O per fetch and output per frame)
+
+   \return Number of lines
+*/
+int prof_get(struct top_context *ctx, const char *dummy);
+
 void help_entry_render(struct top_context *ctx,
 		       char *buff, int group1, int group2);
 
@@ -94,53 +94,145 @@ static void console_move(struct top_context *ctx, int y, int x)
 	(void)fprintf(stdout, "\033[%d;%dH", y + 1, x + 1);
 }
 
-static void console_refresh(struct top_context *ctx)
+/** Scroll rows of a DECSTBM scroll region by deleting (or inserting) lines
+    at its top; the rows outside the region stay */
+static void console_scroll(struct top_context *ctx, int top, int bottom,
+			   int n)
 {
-	fflush(stdout);
+	(void)fprintf(stdout, "\033[%d;%dr\033[%d;1H\033[%d%c\033[r",
+		      top + 1, bottom + 1, top + 1, n > 0 ? n : -n,
+		      n > 0 ? 'M' : 'L');
 }
 
-static int console_getch(struct top_context *ctx)
+static void console_refresh(struct top_context *ctx)
 {
-	uint8_t c;
-	cyg_uint32 len = 1;
-	cyg_io_handle_t t;
-	Cyg_ErrNo err = cyg_io_lookup("/dev/ser0", &t);
+	fflush(stdout);
+}
 
-	if (err)
-		return 0;
+/** Serial console input state */
+struct ecos_console {
+	cyg_io_handle_t handle;
+	/** Receive buffer of the serial driver */
+	cbuf_t *cbuf;
+};
 
-	if (cyg_io_read(t, &c, &len))
-		return 0;
-	else
-		return (int)c;
-}
+/** Look up the console device once per context
 
-int console_hasch(struct top_context *ctx)
+   \return Console state; NULL if the device can't be used
+*/
+static struct ecos_console *console_get(struct top_context *ctx)
 {
-	cyg_io_handle_t handle;
-	Cyg_ErrNo err = cyg_io_lookup("/dev/ser0", &handle);
-	int has_input;
+	struct ecos_console *con = ctx->console;
+	cyg_devtab_entry_t *t;
 
-	(void)err;
+	if (con)
+		return con;
+
+	con = calloc(1, sizeof(*con));
+	if (!con)
+		return NULL;
+
+	if (cyg_io_lookup(TOP_ECOS_CONSOLE, &con->handle)) {
+		free(con);
+		return NULL;
+	}
 
 	/* we don't want to enable CYGPKG_IO_SERIAL_SELECT_SUPPORT for
 	 * 'cyg_io_select' because it depends on
 	 * fileio and brings a lot of other stuff and problems; just
-	 * read number of received byted directly for serial device */
+	 * use the receive buffer of the serial device directly */
+	t = (cyg_devtab_entry_t *)con->handle;
+	con->cbuf = &((serial_channel *)t->priv)->in_cbuf;
 
-	cyg_devtab_entry_t *t = (cyg_devtab_entry_t *)handle;
-	serial_channel *chan = (serial_channel *)t->priv;
+	ctx->console = con;
 
-	cbuf_t *cbuf = &chan->in_cbuf;
+	return con;
+}
+
+/** Get number of bytes received by the driver, optionally waiting for the
+    first one
+
+   \param[in] con  Console state
+   \param[in] wait Time (in ms) to wait if nothing was received yet
+
+   \return Number of bytes in the receive buffer
+*/
+static cyg_uint32 console_received(struct ecos_console *con,
+				   unsigned int wait)
+{
+	cbuf_t *cbuf = con->cbuf;
+	/* 10 ms ticks */
+	cyg_tick_count_t until = cyg_current_time() + (wait + 9) / 10;
+	cyg_uint32 nb;
 
 	cyg_drv_mutex_lock(&cbuf->lock);
-	has_input = cbuf->nb != 0;
+	cyg_drv_dsr_lock();
+
+	/* the driver signals the condition on every received byte */
+	while (!cbuf->nb && wait && cyg_current_time() < until) {
+		cbuf->waiting = true;
+		if (!cyg_drv_cond_timed_wait(&cbuf->wait, until))
+			break;
+	}
+	cbuf->waiting = false;
+	nb = cbuf->nb;
+
+	cyg_drv_dsr_unlock();
 	cyg_drv_mutex_unlock(&cbuf->lock);
 
-	if (!has_input)
+	return nb;
+}
+
+/** Read all received bytes at once; blocks for one byte if there are none */
+static int console_input(struct top_context *ctx, char *buf, size_t size)
+{
+	struct ecos_console *con = console_get(ctx);
+	cyg_uint32 len;
+
+	if (!con)
+		return 0;
+
+	len = console_received(con, 0);
+	if (!len)
+		len = 1;
+	if (len > size)
+		len = size;
+
+	if (cyg_io_read(con->handle, buf, &len))
+		return 0;
+
+	return (int)len;
+}
+
+static int console_getch(struct top_context *ctx)
+{
+	char c;
+
+	if (console_input(ctx, &c, 1) != 1)
+		return 0;
+
+	return (int)(unsigned char)c;
+}
+
+/** Check for a key; while there is none, wait until the next update is due
+    (ctx->key_wait) or the serial driver receives one */
+int console_hasch(struct top_context *ctx)
+{
+	struct ecos_console *con = console_get(ctx);
+
+	if (!con) {
 		cyg_thread_delay(10);
+		return 0;
+	}
+
+	return console_received(con, ctx->key_wait) != 0;
+}
 
-	return has_input;
+/** Release console state */
+static void console_endwin(struct top_context *ctx)
+{
+	free(ctx->console);
+	ctx->console = NULL;
 }
 
 static void console_terminal_size_get(struct top_context *ctx)
@@ -158,9 +250,13 @@ const struct top_operations console_top_ops = {
 	.clear = console_clear,
 	.move = console_move,
 	.refresh = console_refresh,
+	.scroll = console_scroll,
 	.getch = console_getch,
 	.hasch = console_hasch,
 	.terminal_size_get = console_terminal_size_get,
+	.input = console_input,
+
+	.endwin = console_endwin,
 };
 
 int ecos_file_read(struct top_context *ctx, const char *name, const bool onu)
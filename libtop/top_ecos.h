@@ -12,6 +12,11 @@
 
 #define TOP_CRLF	"\n\r"
 
+/** Serial console device */
+#define TOP_ECOS_CONSOLE	"/dev/ser0"
+
+struct ecos_console;
+
 extern const struct top_operations console_top_ops;
 
 #endif
@@ -0,0 +1,395 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_fetch.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+/** File read worker; never touches the context, so a read left behind on
+    a hung handler can outlive it */
+struct fetch_worker {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+
+	/** Read requested */
+	bool request;
+	/** Requested read finished */
+	bool done;
+	/** Exit after the running read */
+	bool quit;
+	/** Nobody waits for the thread anymore, it frees the worker */
+	bool detached;
+
+	char path[TOP_PROC_ROOT_LEN + TOP_LINE_LEN];
+	/** Read error (file can't be opened) */
+	bool err;
+	/** Syscalls of the read */
+	uint64_t syscalls;
+	char *buff;
+	size_t size;
+	size_t len;
+};
+
+struct top_fetch {
+	/** Idle worker; NULL until the first read */
+	struct fetch_worker *worker;
+	/** Read left behind of each page; NULL if none */
+	struct fetch_worker **hung;
+};
+
+void top_fetch_timeout_set(struct top_context *ctx, unsigned int timeout)
+{
+	ctx->fetch_timeout = timeout;
+}
+
+static void worker_free(struct fetch_worker *wk)
+{
+	pthread_cond_destroy(&wk->cond);
+	pthread_mutex_destroy(&wk->lock);
+	free(wk->buff);
+	free(wk);
+}
+
+static void worker_read(struct fetch_worker *wk)
+{
+	ssize_t n;
+	int fd;
+
+	fd = open(wk->path, O_RDONLY);
+	wk->syscalls++;
+	if (fd < 0) {
+		wk->err = true;
+		return;
+	}
+
+	while (wk->len < wk->size) {
+		n = read(fd, wk->buff + wk->len, wk->size - wk->len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		wk->syscalls++;
+		if (n <= 0)
+			break;
+		wk->len += n;
+	}
+
+	close(fd);
+	wk->syscalls++;
+}
+
+static void *worker_thread(void *arg)
+{
+	struct fetch_worker *wk = arg;
+	bool detached;
+
+	pthread_mutex_lock(&wk->lock);
+	while (!wk->quit) {
+		if (!wk->request) {
+			pthread_cond_wait(&wk->cond, &wk->lock);
+			continue;
+		}
+
+		pthread_mutex_unlock(&wk->lock);
+		worker_read(wk);
+		pthread_mutex_lock(&wk->lock);
+
+		wk->request = false;
+		wk->done = true;
+		pthread_cond_broadcast(&wk->cond);
+	}
+	detached = wk->detached;
+	pthread_mutex_unlock(&wk->lock);
+
+	if (detached)
+		worker_free(wk);
+
+	return NULL;
+}
+
+static struct fetch_worker *worker_create(size_t size)
+{
+	struct fetch_worker *wk;
+	pthread_condattr_t attr;
+
+	wk = calloc(1, sizeof(*wk));
+	if (!wk)
+		return NULL;
+
+	wk->buff = malloc(size);
+	if (!wk->buff) {
+		free(wk);
+		return NULL;
+	}
+	wk->size = size;
+
+	pthread_mutex_init(&wk->lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&wk->cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	if (pthread_create(&wk->thread, NULL, worker_thread, wk)) {
+		worker_free(wk);
+		return NULL;
+	}
+
+	return wk;
+}
+
+/** Stop worker whose read is left behind; it is freed once the read
+    returns */
+static void worker_release(struct fetch_worker *wk)
+{
+	bool done;
+
+	pthread_mutex_lock(&wk->lock);
+	done = wk->done;
+	if (!done)
+		wk->detached = true;
+	pthread_mutex_unlock(&wk->lock);
+
+	if (!done) {
+		pthread_detach(wk->thread);
+		return;
+	}
+
+	pthread_join(wk->thread, NULL);
+	worker_free(wk);
+}
+
+/** Free the workers whose hung read returned meanwhile */
+static void hung_reap(struct top_context *ctx, struct top_fetch *f)
+{
+	struct fetch_worker *wk;
+	unsigned int i;
+	bool done;
+
+	for (i = 0; i < ctx->page_num; i++) {
+		wk = f->hung[i];
+		if (!wk)
+			continue;
+
+		pthread_mutex_lock(&wk->lock);
+		done = wk->done;
+		pthread_mutex_unlock(&wk->lock);
+
+		if (!done)
+			continue;
+
+		pthread_join(wk->thread, NULL);
+		worker_free(wk);
+		f->hung[i] = NULL;
+	}
+}
+
+static struct top_fetch *fetch_get(struct top_context *ctx)
+{
+	struct top_fetch *f = ctx->fetch;
+
+	if (f)
+		return f;
+
+	f = calloc(1, sizeof(*f));
+	if (!f)
+		return NULL;
+
+	f->hung = calloc(ctx->page_num, sizeof(*f->hung));
+	if (!f->hung) {
+		free(f);
+		return NULL;
+	}
+
+	ctx->fetch = f;
+
+	return f;
+}
+
+int fetch_file_read(struct top_context *ctx, const char *path, size_t *size)
+{
+	struct top_fetch *f = fetch_get(ctx);
+	struct fetch_worker *wk;
+	struct timespec ts;
+	bool done;
+
+	if (!f)
+		return -2;
+
+	if (!f->worker)
+		f->worker = worker_create(sizeof(ctx->shared_buff));
+	wk = f->worker;
+	if (!wk)
+		return -2;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	ts.tv_sec += ctx->fetch_timeout / 1000;
+	ts.tv_nsec += (long)(ctx->fetch_timeout % 1000) * 1000000;
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&wk->lock);
+	snprintf(wk->path, sizeof(wk->path), "%s", path);
+	wk->err = false;
+	wk->syscalls = 0;
+	wk->len = 0;
+	wk->done = false;
+	wk->request = true;
+	pthread_cond_broadcast(&wk->cond);
+
+	while (!wk->done)
+		if (pthread_cond_timedwait(&wk->cond, &wk->lock, &ts) ==
+		    ETIMEDOUT)
+			break;
+
+	done = wk->done;
+	if (!done)
+		wk->quit = true;
+	pthread_mutex_unlock(&wk->lock);
+
+	if (!done) {
+		/* the next read gets a new worker */
+		f->worker = NULL;
+
+		if (ctx->fetch_page < ctx->page_num &&
+		    !f->hung[ctx->fetch_page])
+			f->hung[ctx->fetch_page] = wk;
+		else
+			worker_release(wk);
+
+		return 1;
+	}
+
+	ctx->prof.syscalls += wk->syscalls;
+	ctx->prof.bytes_read += wk->len;
+
+	if (wk->err)
+		return -1;
+
+	memcpy(&ctx->shared_buff[0][0], wk->buff, wk->len);
+	*size = wk->len;
+
+	return 0;
+}
+
+bool fetch_blocked(struct top_context *ctx, unsigned int page_idx)
+{
+	struct top_fetch *f = ctx->fetch;
+
+	if (f) {
+		hung_reap(ctx, f);
+		if (f->hung[page_idx])
+			return true;
+	}
+
+	return top_time_ms() < ctx->page_state[page_idx].backoff;
+}
+
+void fetch_done(struct top_context *ctx, unsigned int page_idx,
+		bool timed_out)
+{
+	struct top_page_state *state = &ctx->page_state[page_idx];
+	unsigned int shift;
+
+	if (!timed_out) {
+		state->stale = false;
+		state->timeouts = 0;
+		top_time_get(&state->fresh_time);
+		return;
+	}
+
+	shift = state->timeouts < TOP_FETCH_BACKOFF_MAX ?
+		state->timeouts : TOP_FETCH_BACKOFF_MAX;
+
+	state->stale = true;
+	state->timeouts++;
+	state->backoff = top_time_ms() +
+		((uint64_t)top_page_interval_get(ctx, page_idx) << shift);
+}
+
+int fetch_stale_get(struct top_context *ctx, unsigned int page_idx)
+{
+	int total;
+
+	/* nothing else was fetched since */
+	if (ctx->buff_page == page_idx)
+		return ctx->page_state[page_idx].total > 0 ?
+		       ctx->page_state[page_idx].total : 0;
+
+	total = prefetch_restore(ctx, page_idx, UINT_MAX);
+	if (total >= 0)
+		return total;
+
+	memset(&ctx->line_cache[0], 0, sizeof(ctx->line_cache));
+	ctx->shared_buff[0][0] = 0;
+
+	return 0;
+}
+
+bool fetch_status_get(struct top_context *ctx, unsigned int page_idx,
+		      char *buff, size_t size)
+{
+	const struct top_page_state *state = &ctx->page_state[page_idx];
+	char since[16];
+	struct tm tm;
+	time_t t;
+
+	if (!state->stale)
+		return false;
+
+	if (!state->fresh_time.tv_sec) {
+		snprintf(buff, size, "No data, fetch timed out");
+		return true;
+	}
+
+	t = state->fresh_time.tv_sec;
+	localtime_r(&t, &tm);
+	strftime(since, sizeof(since), "%H:%M:%S", &tm);
+	snprintf(buff, size, "Stale since %s", since);
+
+	return true;
+}
+
+void fetch_shutdown(struct top_context *ctx)
+{
+	struct top_fetch *f = ctx->fetch;
+	struct fetch_worker *wk;
+	unsigned int i;
+
+	if (!f)
+		return;
+
+	wk = f->worker;
+	if (wk) {
+		pthread_mutex_lock(&wk->lock);
+		wk->quit = true;
+		pthread_cond_broadcast(&wk->cond);
+		pthread_mutex_unlock(&wk->lock);
+
+		pthread_join(wk->thread, NULL);
+		worker_free(wk);
+	}
+
+	for (i = 0; i < ctx->page_num; i++)
+		if (f->hung[i])
+			worker_release(f->hung[i]);
+
+	free(f->hung);
+	free(f);
+	ctx->fetch = NULL;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_fetch_h
+#define __top_fetch_h
+
+/** Default deadline (in ms) of a page file read */
+#define TOP_FETCH_TIMEOUT_DEFAULT 2000
+
+/** Maximum backoff of a page that keeps timing out, as power of two of
+    its update interval */
+#define TOP_FETCH_BACKOFF_MAX 6
+
+struct top_context;
+
+/** Set deadline of the page file reads
+
+   The files are read by a worker thread; a page whose read misses the
+   deadline keeps its last data and is shown as stale. Its read is left
+   behind and the page isn't read again before the read returned; pages
+   that time out again are retried after exponentially growing delays.
+
+   \param[in] ctx     Context
+   \param[in] timeout Deadline (in ms); 0 to read in the calling thread
+                      without a deadline
+*/
+void top_fetch_timeout_set(struct top_context *ctx, unsigned int timeout);
+
+/** Read file into the shared buffer by the worker thread
+
+   \param[in]  ctx  Context
+   \param[in]  path File to read
+   \param[out] size Number of bytes read
+
+   \return 0 on success; 1 if the read timed out; -1 if the file can't be
+           opened; -2 if there is no worker thread
+*/
+int fetch_file_read(struct top_context *ctx, const char *path, size_t *size);
+
+/** Check whether a page is backed off or its previous read still hangs */
+bool fetch_blocked(struct top_context *ctx, unsigned int page_idx);
+
+/** Account result of a page fetch
+
+   \param[in] ctx       Context
+   \param[in] page_idx  Fetched page
+   \param[in] timed_out Fetch missed its deadline
+*/
+void fetch_done(struct top_context *ctx, unsigned int page_idx,
+		bool timed_out);
+
+/** Get the last data of a page which couldn't be fetched
+
+   \return Number of lines
+*/
+int fetch_stale_get(struct top_context *ctx, unsigned int page_idx);
+
+/** Get status of a stale page
+
+   \param[in]  ctx      Context
+   \param[in]  page_idx Page
+   \param[out] buff     Status text ("Stale since <time>")
+   \param[in]  size     Size of buff
+
+   \return true if the page is stale
+*/
+bool fetch_status_get(struct top_context *ctx, unsigned int page_idx,
+		      char *buff, size_t size);
+
+/** Stop the worker threads; hung reads are left to exit on their own */
+void fetch_shutdown(struct top_context *ctx);
+
+#endif
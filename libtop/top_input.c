@@ -0,0 +1,194 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_input.h"
+
+/** Largest CSI parameter kept; longer numbers aren't key codes */
+#define INPUT_PARAM_MAX 9999
+
+void input_init(struct top_context *ctx)
+{
+	memset(&ctx->input, 0, sizeof(ctx->input));
+	ctx->input.state = TOP_INPUT_GROUND;
+}
+
+static void key_queue(struct top_input *in, int key)
+{
+	if (in->num == TOP_INPUT_KEYS)
+		return;
+
+	in->key[(in->head + in->num++) % TOP_INPUT_KEYS] = key;
+}
+
+/** Decode the final character of a CSI or SS3 sequence
+
+   \return Key; 0 if the sequence isn't a known key
+*/
+static int key_decode(int c, unsigned int param)
+{
+	switch (c) {
+	case 'A':
+		return KEY_UP;
+	case 'B':
+		return KEY_DOWN;
+	case 'C':
+		return KEY_RIGHT;
+	case 'D':
+		return KEY_LEFT;
+	case 'H':
+		return KEY_HOME;
+	case 'F':
+		return KEY_END;
+	case '~':
+		/* VT220 editing keys; 1/4 on PuTTY, 7/8 on rxvt */
+		switch (param) {
+		case 1:
+		case 7:
+			return KEY_HOME;
+		case 4:
+		case 8:
+			return KEY_END;
+		case 5:
+			return KEY_PPAGE;
+		case 6:
+			return KEY_NPAGE;
+		}
+		break;
+	}
+
+	return 0;
+}
+
+/** Feed one input byte to the decoder */
+static void input_feed(struct top_input *in, int c)
+{
+	int key;
+
+	switch (in->state) {
+	case TOP_INPUT_GROUND:
+		if (c == '\033')
+			in->state = TOP_INPUT_ESC;
+		else
+			key_queue(in, c);
+		return;
+
+	case TOP_INPUT_ESC:
+		in->param = 0;
+		switch (c) {
+		case '[':
+			in->state = TOP_INPUT_CSI;
+			break;
+		case 'O':
+			in->state = TOP_INPUT_SS3;
+			break;
+		case '\033':
+			/* the first ESC was pressed alone */
+			break;
+		default:
+			/* Alt+key isn't used; a control key after ESC is */
+			in->state = TOP_INPUT_GROUND;
+			if (c < 0x20)
+				input_feed(in, c);
+			break;
+		}
+		return;
+
+	case TOP_INPUT_CSI:
+		/* parameters; modifiers (";5") and private markers are
+		 * skipped */
+		if (c >= '0' && c <= '9') {
+			if (in->param <= INPUT_PARAM_MAX)
+				in->param = in->param * 10 + (c - '0');
+			return;
+		}
+
+		if (c >= 0x20 && c < 0x40)
+			return;
+
+		/* a sequence broken by a control character is dropped */
+		if (c < 0x20 || c > 0x7e) {
+			in->state = TOP_INPUT_GROUND;
+			input_feed(in, c);
+			return;
+		}
+		break;
+
+	case TOP_INPUT_SS3:
+		break;
+	}
+
+	in->state = TOP_INPUT_GROUND;
+
+	key = key_decode(c, in->param);
+	if (key)
+		key_queue(in, key);
+}
+
+/** Read the terminal; blocks until at least one byte is read
+
+   \return Number of bytes read; 0 if the terminal input ended
+*/
+static int input_fill(struct top_context *ctx)
+{
+	struct top_input *in = &ctx->input;
+	char buff[TOP_INPUT_LEN];
+	int num, i, c;
+
+	in->reads++;
+
+	if (!ctx->ops->input) {
+		c = ctx->ops->getch(ctx);
+		if (c <= 0)
+			return 0;
+
+		in->bytes++;
+
+		/* backends decoding keys themselves */
+		if (c > 0xff)
+			key_queue(in, c);
+		else
+			input_feed(in, c);
+
+		return 1;
+	}
+
+	num = ctx->ops->input(ctx, buff, TOP_INPUT_KEYS - in->num);
+	if (num <= 0)
+		return 0;
+
+	in->bytes += num;
+	for (i = 0; i < num; i++)
+		input_feed(in, (unsigned char)buff[i]);
+
+	return num;
+}
+
+int input_key(struct top_context *ctx)
+{
+	struct top_input *in = &ctx->input;
+	int key;
+
+	/* an incomplete escape sequence is completed by the next read */
+	while (!in->num)
+		if (!input_fill(ctx))
+			return 0;
+
+	key = in->key[in->head];
+	in->head = (in->head + 1) % TOP_INPUT_KEYS;
+	in->num--;
+
+	return key;
+}
+
+bool input_pending(struct top_context *ctx)
+{
+	return ctx->input.num != 0;
+}
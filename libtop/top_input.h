@@ -0,0 +1,64 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_input_h
+#define __top_input_h
+
+/** Maximum number of bytes read from the terminal at once */
+#define TOP_INPUT_LEN 256
+
+/** Maximum number of decoded keys queued; each byte read decodes to one
+    key at most */
+#define TOP_INPUT_KEYS TOP_INPUT_LEN
+
+struct top_context;
+
+/** Escape sequence decoder state */
+enum top_input_state {
+	/** Plain characters */
+	TOP_INPUT_GROUND,
+	/** ESC received */
+	TOP_INPUT_ESC,
+	/** ESC [ received; parameters follow */
+	TOP_INPUT_CSI,
+	/** ESC O received; one final character follows */
+	TOP_INPUT_SS3
+};
+
+/** Terminal input state */
+struct top_input {
+	/** Decoded keys not processed yet */
+	int key[TOP_INPUT_KEYS];
+	unsigned int head, num;
+	/** Decoder state and first parameter of a CSI sequence */
+	enum top_input_state state;
+	unsigned int param;
+
+	/** Number of reads from the terminal */
+	uint64_t reads;
+	/** Number of bytes read */
+	uint64_t bytes;
+};
+
+/** Initialize input state */
+void input_init(struct top_context *ctx);
+
+/** Get next key; reads the terminal if no decoded key is queued
+
+   Escape sequences of the cursor and editing keys (CSI and SS3, as sent by
+   xterm, PuTTY and VT100 terminals) are decoded to KEY_*; other sequences
+   are dropped.
+
+   \return Key; 0 if the terminal input ended
+*/
+int input_key(struct top_context *ctx);
+
+/** Check whether decoded keys are queued */
+bool input_pending(struct top_context *ctx);
+
+#endif
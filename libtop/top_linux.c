@@ -15,22 +15,21 @@
 #include <stdio.h>
 #include <sys/ioctl.h>
 #include <sys/select.h>
+#include <fcntl.h>
 
 #include "gpon_libs_config.h"
 #include "top.h"
 #include "top_linux.h"
 
-static struct termios orig_opts;
-
 static void console_cbreak(struct top_context *ctx)
 {
 	struct termios opts;
 	int res = 0;
 
-	res = tcgetattr(STDIN_FILENO, &orig_opts);
+	res = tcgetattr(STDIN_FILENO, &ctx->orig_opts);
 	assert(res == 0);
 
-	memcpy(&opts, &orig_opts, sizeof(opts));
+	memcpy(&opts, &ctx->orig_opts, sizeof(opts));
 	opts.c_cc[VMIN] = 1;
 	opts.c_lflag &= ~(ECHO | ECHOE | ECHOK | ECHONL | ICANON | IEXTEN | ICRNL);
 	tcsetattr(STDIN_FILENO, TCSANOW, &opts);
@@ -38,7 +37,7 @@ static void console_cbreak(struct top_context *ctx)
 
 static void console_endwin(struct top_context *ctx)
 {
-	tcsetattr(STDIN_FILENO, TCSANOW, &orig_opts);
+	tcsetattr(STDIN_FILENO, TCSANOW, &ctx->orig_opts);
 }
 
 static void console_addstr(struct top_context *ctx, const char *s)
@@ -89,6 +88,16 @@ static void console_curs_set(struct top_context *ctx, int flag)
 	}
 }
 
+/** Scroll rows of a DECSTBM scroll region by deleting (or inserting) lines
+    at its top; the rows outside the region stay */
+static void console_scroll(struct top_context *ctx, int top, int bottom,
+			   int n)
+{
+	(void)fprintf(stdout, "\033[%d;%dr\033[%d;1H\033[%d%c\033[r",
+		      top + 1, bottom + 1, top + 1, n > 0 ? n : -n,
+		      n > 0 ? 'M' : 'L');
+}
+
 static void console_refresh(struct top_context *ctx)
 {
 	fflush(stdout);
@@ -135,60 +144,25 @@ static void console_terminal_size_get(struct top_context *ctx)
 
 static int console_getch(struct top_context *ctx)
 {
-	char c = 10;
-	ssize_t err;
+	unsigned char c;
 
-	if (!read(0, &c, 1))
+	if (read(0, &c, 1) != 1)
 		return 0;
 
-	if (c == '\033') {
-		if (!read(0, &c, 1))
-			return 0;
-
-		if (c != '[')
-			return 0;
-
-		if (!read(0, &c, 1))
-			return 0;
+	return (int)c;
+}
 
-		/* suitable for PuTTY default settings; need to fix if other
-		 * escase sequences are to be used */
-		switch (c) {
-		case 'A':
-			return KEY_UP;
-		case 'B':
-			return KEY_DOWN;
-		case 'C':
-			return KEY_RIGHT;
-		case 'D':
-			return KEY_LEFT;
-		case '1':
-			err = read(0, &c, 1);
-			if (err != 1)
-				return 0;
-			return KEY_HOME;
-		case '4':
-			err = read(0, &c, 1);
-			if (err != 1)
-				return 0;
-			return KEY_END;
-		case '5':
-			err = read(0, &c, 1);
-			if (err != 1)
-				return 0;
-			return KEY_PPAGE;
-		case '6':
-			err = read(0, &c, 1);
-			if (err != 1)
-				return 0;
-			return KEY_NPAGE;
-		default:
+/** Read all bytes the terminal has buffered (a burst of keys or pasted
+    text) with one syscall */
+static int console_input(struct top_context *ctx, char *buf, size_t size)
+{
+	ssize_t n;
 
-			return 0;
-		}
-	}
+	do
+		n = read(0, buf, size);
+	while (n < 0 && errno == EINTR && !ctx->need_shutdown);
 
-	return (int)c;
+	return n > 0 ? (int)n : 0;
 }
 
 static int console_hasch(struct top_context *ctx)
@@ -219,32 +193,70 @@ const struct top_operations console_top_ops = {
 	.clear = console_clear,
 	.move = console_move,
 	.refresh = console_refresh,
+	.scroll = console_scroll,
 	.getch = console_getch,
 	.hasch = console_hasch,
 	.terminal_size_get = console_terminal_size_get,
+	.input = console_input,
 
 	.cbreak = console_cbreak,
 	.endwin = console_endwin,
 };
 
-int linux_file_read(struct top_context *ctx, const char *name)
+size_t linux_fd_read(struct top_context *ctx, int fd)
+{
+	size_t s = 0;
+	ssize_t n;
+
+	/* proc handlers return at most a page per read */
+	while (s < sizeof(ctx->shared_buff)) {
+		n = read(fd, &ctx->shared_buff[0][0] + s,
+			 sizeof(ctx->shared_buff) - s);
+		if (n < 0 && errno == EINTR)
+			continue;
+		prof_read(ctx, n > 0 ? n : 0);
+		if (n <= 0)
+			break;
+		s += n;
+	}
+
+	return s;
+}
+
+int linux_text_parse(struct top_context *ctx, size_t s)
 {
 	int i, k=0;
 	char *p = &ctx->shared_buff[0][0];
+	char *end = p;
 	static char *more_data = "... more data available";
-	size_t s;
-	FILE *f;
+	const char *filter = ctx->fetch_filter ? ctx->filter : "";
+	uint64_t filter_hash = 0;
+	uint64_t start;
 
-	memset(&ctx->line_cache[0], 0, sizeof(ctx->line_cache));
-	*p = 0;
+	start = top_time_us();
 
-	f = fopen(name, "r");
-	if (!f)
-		return 0;
+	/* lets the update interval adapt to the content changes */
+	ctx->fetch_hash = top_hash(p, s);
+
+	if (filter[0])
+		filter_hash = top_hash(filter, strlen(filter));
 
-	s = fread(&ctx->shared_buff[0][0], 1, sizeof(ctx->shared_buff), f);
+	if (ctx->parsed_size && ctx->parsed_size == s &&
+	    ctx->parsed_hash == ctx->fetch_hash &&
+	    ctx->parsed_filter == filter_hash) {
+		/* same text as parsed last: the line cache is still valid,
+		   only the line ends have to be cut again */
+		end = p + ctx->parsed_end;
+		while ((p = memchr(p, '\n', end - p)) != NULL)
+			*p++ = 0;
 
-	fclose(f);
+		ctx->fetch_reused = true;
+		ctx->prof.parse += top_time_us() - start;
+
+		return ctx->parsed_lines;
+	}
+
+	memset(&ctx->line_cache[0], 0, sizeof(ctx->line_cache));
 
 	for(i=0;(unsigned int)i<s && k<TOP_LINE_MAX;i++,p++) {
 		if(*p == 0)
@@ -254,29 +266,127 @@ int linux_file_read(struct top_context *ctx, const char *name)
 		if(*p != '\n')
 			continue;
 		*p = 0;
+		end = p + 1;
+		/* lines the filter hides aren't indexed at all */
+		if (filter[0] && !strstr(ctx->line_cache[k], filter)) {
+			ctx->line_cache[k] = NULL;
+			continue;
+		}
 		k++;
 	}
 
 	if(k == TOP_LINE_MAX)
 		ctx->line_cache[k-1] = more_data;
 
+	ctx->parsed_hash = ctx->fetch_hash;
+	ctx->parsed_size = s;
+	ctx->parsed_end = end - &ctx->shared_buff[0][0];
+	ctx->parsed_lines = k;
+	ctx->parsed_filter = filter_hash;
+
+	ctx->prof.parse += top_time_us() - start;
+
 	return k;
 }
 
+int linux_text_refilter(struct top_context *ctx)
+{
+	char *p = &ctx->shared_buff[0][0];
+	size_t i, s = ctx->parsed_size;
+
+	if (!s)
+		return -1;
+
+	/* the text ends at the first 0, all before the last cut line end
+	   are cut line ends */
+	for (i = 0; i < ctx->parsed_end; i++)
+		if (p[i] == 0)
+			p[i] = '\n';
+
+	ctx->parsed_size = 0;
+
+	return linux_text_parse(ctx, s);
+}
+
+int linux_file_read(struct top_context *ctx, const char *name)
+{
+	size_t s;
+	int fd;
+
+	if (ctx->fetch_timeout) {
+		switch (fetch_file_read(ctx, name, &s)) {
+		case 0:
+			return linux_text_parse(ctx, s);
+		case 1:
+			/* the shared buffer is left as it was */
+			ctx->fetch_timed_out = true;
+			return 0;
+		case -1:
+			ctx->shared_buff[0][0] = 0;
+			return linux_text_parse(ctx, 0);
+		default:
+			/* no worker thread, read without deadline */
+			break;
+		}
+	}
+
+	ctx->shared_buff[0][0] = 0;
+
+	fd = open(name, O_RDONLY);
+	ctx->prof.syscalls++;
+	if (fd < 0)
+		return linux_text_parse(ctx, 0);
+
+	s = linux_fd_read(ctx, fd);
+
+	close(fd);
+	ctx->prof.syscalls++;
+
+	return linux_text_parse(ctx, s);
+}
+
+/** Build path of a driver procfs file */
+static void proc_path(struct top_context *ctx, const char *driver,
+		      const char *name, char *path, size_t size)
+{
+	snprintf(path, size, "%s/driver/%s/%s", ctx->proc_root, driver, name);
+}
+
 int onu_top_proc_get(struct top_context *ctx, const char *name)
 {
-	char tmp[64];
+	char tmp[TOP_PROC_ROOT_LEN + 64];
 
-	snprintf(tmp, sizeof(tmp), "/proc/driver/onu/%s", name);
+	proc_path(ctx, "onu", name, tmp, sizeof(tmp));
 	return linux_file_read(ctx, tmp);
 }
 
 int optic_top_proc_get(struct top_context *ctx, const char *name)
 {
-	char tmp[64];
+	char tmp[TOP_PROC_ROOT_LEN + 64];
 
-	snprintf(tmp, sizeof(tmp), "/proc/driver/optic/%s", name);
+	proc_path(ctx, "optic", name, tmp, sizeof(tmp));
 	return linux_file_read(ctx, tmp);
 }
 
+int linux_page_path(struct top_context *ctx, unsigned int page_idx,
+		    char *path, size_t size)
+{
+	const struct top_page_desc *page = &ctx->page[page_idx];
+
+	if (page->source)
+		return source_path(ctx, page->source, path, size);
+
+	if (!page->input_file_name)
+		return -1;
+
+	if (page->page_get == onu_top_proc_get)
+		proc_path(ctx, "onu", page->input_file_name, path, size);
+	else if (page->page_get == optic_top_proc_get)
+		proc_path(ctx, "optic", page->input_file_name, path, size);
+	else
+		return -1;
+
+	return 0;
+}
+
 #endif
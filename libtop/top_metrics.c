@@ -0,0 +1,466 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_table.h"
+#include "top_metrics.h"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/** Metrics of one page, rendered after each fetch */
+struct metrics_page {
+	unsigned int page_idx;
+	/** Snapshot generation the text belongs to; 0 if none */
+	uint32_t gen;
+	char *text;
+	size_t len;
+};
+
+/** Scrape connection */
+struct metrics_conn {
+	int fd;
+	/** Request head received so far */
+	char in[TOP_LINE_LEN];
+	size_t in_len;
+	/** Reply; NULL until the request head is complete */
+	char *out;
+	size_t out_len;
+	size_t out_off;
+	/** Time (in ms) the connection is dropped at */
+	uint64_t deadline;
+};
+
+struct top_metrics {
+	/** Listening socket */
+	int fd;
+	struct metrics_page page[TOP_METRICS_PAGE_MAX];
+	unsigned int page_num;
+	/** Time (in ms) of the last refresh */
+	uint64_t refreshed;
+	struct metrics_conn conn[TOP_METRICS_CONN_MAX];
+	unsigned int conn_num;
+};
+
+int top_metrics_init(struct top_context *ctx, const char *addr,
+		     unsigned short port)
+{
+	struct top_metrics *m;
+	struct sockaddr_in sa;
+	int on = 1;
+
+	if (ctx->metrics)
+		return -1;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sin_family = AF_INET;
+	sa.sin_port = htons(port);
+	if (inet_pton(AF_INET, addr, &sa.sin_addr) != 1)
+		return -1;
+
+	m = malloc(sizeof(*m));
+	if (!m)
+		return -1;
+
+	memset(m, 0, sizeof(*m));
+	m->fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (m->fd < 0) {
+		free(m);
+		return -1;
+	}
+
+	if (setsockopt(m->fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) ||
+	    bind(m->fd, (struct sockaddr *)&sa, sizeof(sa)) ||
+	    listen(m->fd, 8)) {
+		close(m->fd);
+		free(m);
+		return -1;
+	}
+
+	ctx->metrics = m;
+
+	return 0;
+}
+
+static void conn_close(struct metrics_conn *c)
+{
+	close(c->fd);
+	free(c->out);
+	memset(c, 0, sizeof(*c));
+	c->fd = -1;
+}
+
+void top_metrics_shutdown(struct top_context *ctx)
+{
+	struct top_metrics *m = ctx->metrics;
+	unsigned int i;
+
+	if (!m)
+		return;
+
+	for (i = 0; i < m->conn_num; i++)
+		conn_close(&m->conn[i]);
+
+	for (i = 0; i < m->page_num; i++)
+		free(m->page[i].text);
+
+	close(m->fd);
+	free(m);
+	ctx->metrics = NULL;
+}
+
+int top_metrics_page_add(struct top_context *ctx, unsigned int page_idx)
+{
+	struct top_metrics *m = ctx->metrics;
+	unsigned int i;
+
+	if (!m || page_idx >= ctx->page_num)
+		return -1;
+
+	for (i = 0; i < m->page_num; i++)
+		if (m->page[i].page_idx == page_idx)
+			return 0;
+
+	if (m->page_num == TOP_METRICS_PAGE_MAX)
+		return -1;
+
+	memset(&m->page[m->page_num], 0, sizeof(m->page[0]));
+	m->page[m->page_num++].page_idx = page_idx;
+	/* render on the next pass of the server loop */
+	m->refreshed = 0;
+
+	return 0;
+}
+
+int metrics_fd_get(struct top_context *ctx)
+{
+	return ctx->metrics ? ctx->metrics->fd : -1;
+}
+
+unsigned int metrics_pollfd_get(struct top_context *ctx, struct pollfd *pfd)
+{
+	struct top_metrics *m = ctx->metrics;
+	unsigned int i;
+
+	if (!m)
+		return 0;
+
+	pfd[0].fd = m->fd;
+	pfd[0].events = POLLIN;
+	for (i = 0; i < m->conn_num; i++) {
+		pfd[i + 1].fd = m->conn[i].fd;
+		pfd[i + 1].events = m->conn[i].out ? POLLOUT : POLLIN;
+	}
+
+	return m->conn_num + 1;
+}
+
+/** Write metric name part, replacing characters not allowed in names */
+static void name_write(FILE *f, const char *s)
+{
+	bool skip = false;
+
+	for (; *s; s++) {
+		if (isalnum((unsigned char)*s)) {
+			fputc(tolower((unsigned char)*s), f);
+			skip = false;
+		} else if (!skip) {
+			fputc('_', f);
+			skip = true;
+		}
+	}
+}
+
+/** Write label value with the escaping required by the text format */
+static void label_write(FILE *f, const char *s)
+{
+	for (; *s; s++) {
+		if (*s == '\\' || *s == '"')
+			fputc('\\', f);
+		if (*s == '\n')
+			fputs("\\n", f);
+		else
+			fputc(*s, f);
+	}
+}
+
+/** Render metrics of a snapshot
+
+   All samples of a family have to be adjacent, so every numeric column
+   gets its own stream; the rows are split only once.
+
+   \return 0 on success; -1 if out of memory
+*/
+static int page_render(struct top_context *ctx, struct metrics_page *mp,
+		       const struct top_snapshot *snap)
+{
+	struct top_schema schema;
+	char buff[TOP_LINE_LEN];
+	char *col[TOP_COLUMN_MAX];
+	FILE *f[TOP_COLUMN_MAX] = { NULL };
+	char *text[TOP_COLUMN_MAX] = { NULL };
+	size_t len[TOP_COLUMN_MAX] = { 0 };
+	const char *page = ctx->page[snap->page_idx].name;
+	char *out = NULL;
+	size_t out_len = 0;
+	FILE *o;
+	double value;
+	int ret = -1;
+	int i, k, n;
+
+	top_schema_detect(&schema, snapshot_table_line_get, (void *)snap,
+			  snap->total);
+
+	for (k = 1; k < schema.cols; k++) {
+		if (schema.type[k] != TOP_CELL_INT &&
+		    schema.type[k] != TOP_CELL_FLOAT)
+			continue;
+
+		f[k] = open_memstream(&text[k], &len[k]);
+		if (!f[k])
+			goto out;
+
+		fprintf(f[k], "# TYPE " TOP_METRICS_PREFIX);
+		name_write(f[k], page);
+		fputc('_', f[k]);
+		name_write(f[k], schema.name[k]);
+		fprintf(f[k], " gauge\n");
+	}
+
+	for (i = schema.first; i < snap->total; i++) {
+		n = top_columns_split(top_snapshot_line_get(snap, i),
+				      schema.sep, buff, col, TOP_COLUMN_MAX);
+
+		for (k = 1; k < n && k < schema.cols; k++) {
+			if (!f[k] || top_cell_num(col[k], &value))
+				continue;
+
+			fprintf(f[k], TOP_METRICS_PREFIX);
+			name_write(f[k], page);
+			fputc('_', f[k]);
+			name_write(f[k], schema.name[k]);
+			fprintf(f[k], "{page=\"");
+			label_write(f[k], page);
+			fprintf(f[k], "\",row=\"");
+			label_write(f[k], col[0]);
+			fprintf(f[k], "\"} %.17g\n", value);
+		}
+	}
+
+	o = open_memstream(&out, &out_len);
+	if (!o)
+		goto out;
+
+	for (k = 1; k < schema.cols; k++) {
+		if (!f[k])
+			continue;
+
+		fclose(f[k]);
+		f[k] = NULL;
+		fwrite(text[k], 1, len[k], o);
+	}
+	fclose(o);
+
+	free(mp->text);
+	mp->text = out;
+	mp->len = out_len;
+	mp->gen = snap->gen;
+	ret = 0;
+
+out:
+	for (k = 0; k < TOP_COLUMN_MAX; k++) {
+		if (f[k])
+			fclose(f[k]);
+		free(text[k]);
+	}
+
+	return ret;
+}
+
+unsigned int metrics_refresh(struct top_context *ctx)
+{
+	struct top_metrics *m = ctx->metrics;
+	const struct top_snapshot *snap;
+	uint64_t now = top_time_ms();
+	unsigned int i;
+
+	if (!m)
+		return ctx->upd_delay;
+
+	if (m->refreshed && now - m->refreshed < ctx->upd_delay)
+		return ctx->upd_delay - (unsigned int)(now - m->refreshed);
+
+	for (i = 0; i < m->page_num; i++) {
+		snap = snapshot_cache_get(ctx, m->page[i].page_idx,
+					  top_page_interval_get(ctx,
+							m->page[i].page_idx));
+		if (snap && snap->gen != m->page[i].gen)
+			(void)page_render(ctx, &m->page[i], snap);
+	}
+
+	m->refreshed = now;
+
+	return ctx->upd_delay;
+}
+
+/** Build the reply to a complete request head
+
+   The page texts are copied, they may be rendered again while the reply
+   is sent.
+
+   \return 0 on success; -1 if out of memory
+*/
+static int reply_build(struct top_metrics *m, struct metrics_conn *c)
+{
+	const char *type;
+	unsigned int i;
+	FILE *f;
+	bool om;
+
+	f = open_memstream(&c->out, &c->out_len);
+	if (!f)
+		return -1;
+
+	if (strncmp(c->in, "GET /metrics ", 13) != 0 &&
+	    strncmp(c->in, "GET /metrics?", 13) != 0) {
+		fprintf(f, "HTTP/1.0 404 Not Found\r\n"
+			"Content-Type: text/plain\r\n"
+			"Connection: close\r\n\r\n"
+			"Not found\n");
+		return fclose(f) ? -1 : 0;
+	}
+
+	/* Prometheus asks for OpenMetrics explicitly */
+	om = strstr(c->in, "application/openmetrics-text") != NULL;
+	if (om)
+		type = "application/openmetrics-text; version=1.0.0; "
+		       "charset=utf-8";
+	else
+		type = "text/plain; version=0.0.4; charset=utf-8";
+
+	fprintf(f, "HTTP/1.0 200 OK\r\n"
+		"Content-Type: %s\r\n"
+		"Connection: close\r\n\r\n", type);
+
+	for (i = 0; i < m->page_num; i++)
+		if (m->page[i].text)
+			fwrite(m->page[i].text, 1, m->page[i].len, f);
+
+	if (om)
+		fprintf(f, "# EOF\n");
+
+	return fclose(f) ? -1 : 0;
+}
+
+/** Read request head
+
+   \return 0 on success; -1 if the connection has to be closed
+*/
+static int conn_read(struct top_metrics *m, struct metrics_conn *c)
+{
+	ssize_t n;
+
+	n = recv(c->fd, c->in + c->in_len, sizeof(c->in) - 1 - c->in_len, 0);
+	if (n < 0)
+		return errno == EINTR || errno == EAGAIN ? 0 : -1;
+	if (n == 0)
+		return -1;
+
+	c->in_len += n;
+	c->in[c->in_len] = 0;
+
+	if (strstr(c->in, "\r\n\r\n") || strstr(c->in, "\n\n"))
+		return reply_build(m, c);
+
+	/* request head too long */
+	return c->in_len == sizeof(c->in) - 1 ? -1 : 0;
+}
+
+/** Send reply
+
+   \return 0 if more is to be sent; 1 if done; -1 on error
+*/
+static int conn_write(struct metrics_conn *c)
+{
+	ssize_t n;
+
+	n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off,
+		 MSG_NOSIGNAL);
+	if (n < 0)
+		return errno == EINTR || errno == EAGAIN ? 0 : -1;
+
+	c->out_off += n;
+
+	return c->out_off == c->out_len ? 1 : 0;
+}
+
+/** Accept scrape connection */
+static void conn_accept(struct top_metrics *m)
+{
+	struct metrics_conn *c;
+	int fd;
+
+	fd = accept(m->fd, NULL, NULL);
+	if (fd < 0)
+		return;
+
+	if (m->conn_num == TOP_METRICS_CONN_MAX ||
+	    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK)) {
+		close(fd);
+		return;
+	}
+
+	c = &m->conn[m->conn_num++];
+	memset(c, 0, sizeof(*c));
+	c->fd = fd;
+	c->deadline = top_time_ms() + TOP_METRICS_TIMEOUT;
+}
+
+void metrics_poll_handle(struct top_context *ctx, const struct pollfd *pfd)
+{
+	struct top_metrics *m = ctx->metrics;
+	uint64_t now = top_time_ms();
+	unsigned int i, k;
+
+	if (!m)
+		return;
+
+	/* pfd entries match the connections until the compaction below */
+	for (i = 0; i < m->conn_num; i++) {
+		struct metrics_conn *c = &m->conn[i];
+		int ret = 0;
+
+		if (pfd[i + 1].revents & POLLOUT)
+			ret = conn_write(c);
+		else if (pfd[i + 1].revents & POLLIN)
+			ret = conn_read(m, c);
+		else if (pfd[i + 1].revents & (POLLERR | POLLHUP))
+			ret = -1;
+
+		/* idle or slow scrapers are dropped */
+		if (ret || now >= c->deadline)
+			conn_close(c);
+	}
+
+	for (i = 0, k = 0; i < m->conn_num; i++)
+		if (m->conn[i].fd >= 0)
+			m->conn[k++] = m->conn[i];
+	m->conn_num = k;
+
+	if (pfd[0].revents & POLLIN)
+		conn_accept(m);
+}
+
+#endif
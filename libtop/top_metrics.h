@@ -0,0 +1,92 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_metrics_h
+#define __top_metrics_h
+
+/** Default address of the metrics listener */
+#define TOP_METRICS_ADDR_DEFAULT "127.0.0.1"
+
+/** Default TCP port of the metrics listener */
+#define TOP_METRICS_PORT_DEFAULT 9420
+
+/** Maximum number of pages exposed as metrics */
+#define TOP_METRICS_PAGE_MAX 16
+
+/** Time (in ms) a scrape may take from connect to the end of the reply */
+#define TOP_METRICS_TIMEOUT 1000
+
+/** Maximum number of scrapes served at the same time */
+#define TOP_METRICS_CONN_MAX 8
+
+/** Prefix of all metric names */
+#define TOP_METRICS_PREFIX "top_"
+
+struct top_context;
+struct pollfd;
+
+/** Create the metrics HTTP listener
+
+   The listener is served by \ref top_server_run. GET /metrics returns the
+   numeric columns of the selected pages in the OpenMetrics text format,
+   one metric family "top_<page>_<column>" per column with the labels
+   page and row (text of the first column). Selected pages are fetched once
+   per update delay by the server loop; scrapes are answered from the text
+   rendered after the last fetch.
+
+   \param[in] ctx  Context
+   \param[in] addr IPv4 address to listen on
+   \param[in] port TCP port
+
+   \return 0 on success; -1 on error
+*/
+int top_metrics_init(struct top_context *ctx, const char *addr,
+		     unsigned short port);
+
+/** Close the metrics listener */
+void top_metrics_shutdown(struct top_context *ctx);
+
+/** Expose page as metrics
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page
+
+   \return 0 on success; -1 if too many pages are selected
+*/
+int top_metrics_page_add(struct top_context *ctx, unsigned int page_idx);
+
+/** Get listening socket of the metrics endpoint
+
+   \return Socket; -1 if the endpoint is not enabled
+*/
+int metrics_fd_get(struct top_context *ctx);
+
+/** Fetch the selected pages if due and render their metrics
+
+   \return Time (in ms) until the next refresh
+*/
+unsigned int metrics_refresh(struct top_context *ctx);
+
+/** Get descriptors of the metrics endpoint to poll
+
+   \param[in]  ctx Context
+   \param[out] pfd Poll entries of the listening socket and the scrape
+                   connections (1 + TOP_METRICS_CONN_MAX at most)
+
+   \return Number of entries; 0 if the endpoint is not enabled
+*/
+unsigned int metrics_pollfd_get(struct top_context *ctx, struct pollfd *pfd);
+
+/** Accept scrapes and serve them without blocking
+
+   \param[in] ctx Context
+   \param[in] pfd Poll entries set up by \ref metrics_pollfd_get
+*/
+void metrics_poll_handle(struct top_context *ctx, const struct pollfd *pfd);
+
+#endif
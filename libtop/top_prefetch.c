@@ -0,0 +1,226 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_prefetch.h"
+
+void top_prefetch_share_set(struct top_context *ctx, unsigned int percent)
+{
+	ctx->prefetch.share = percent > 100 ? 100 : percent;
+}
+
+void prefetch_init(struct top_context *ctx)
+{
+	memset(&ctx->prefetch, 0, sizeof(ctx->prefetch));
+	ctx->prefetch.share = TOP_PREFETCH_SHARE_DEFAULT;
+	ctx->prefetch.last = top_time_us();
+}
+
+void prefetch_shutdown(struct top_context *ctx)
+{
+	top_snapshot_free(&ctx->prefetch.stash);
+}
+
+void prefetch_visit(struct top_context *ctx, unsigned int prev)
+{
+	struct top_prefetch *pf = &ctx->prefetch;
+	unsigned int i;
+
+	pf->switched = true;
+
+	if (prev >= ctx->page_num)
+		return;
+
+	for (i = 0; i < pf->recent_num && pf->recent[i] != prev; i++)
+		;
+
+	if (i == pf->recent_num && pf->recent_num < TOP_PREFETCH_RECENT)
+		pf->recent_num++;
+
+	/* the oldest page drops out */
+	if (i == TOP_PREFETCH_RECENT)
+		i--;
+
+	memmove(&pf->recent[1], &pf->recent[0], i * sizeof(pf->recent[0]));
+	pf->recent[0] = prev;
+}
+
+bool prefetch_page_check(struct top_context *ctx, unsigned int page_idx)
+{
+	const struct top_page_desc *page = &ctx->page[page_idx];
+
+	/* pages with enter handlers depend on being selected */
+	if (!page->line_get || page->page_enter || page->page_leave ||
+	    (!page->page_get && !page->source))
+		return false;
+
+	/* the help, profile and watch pages only show other pages */
+	if (page->page_get == help_get || page->page_get == prof_get ||
+	    page->page_get == watch_get)
+		return false;
+
+#ifdef LINUX
+	/* extra fetches would distort the recording */
+	if (trigger_page_is_recorded(ctx, page_idx))
+		return false;
+#endif
+
+	return true;
+}
+
+/** Check whether a page is worth prefetching
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page; may be out of range
+   \param[in] now      Current time (in ms)
+*/
+static bool candidate_check(struct top_context *ctx, int page_idx,
+			    uint64_t now)
+{
+	const struct top_snapshot *snap;
+
+	if (page_idx < 0 || page_idx >= (int)ctx->page_num ||
+	    page_idx == (int)ctx->page_sel ||
+	    !prefetch_page_check(ctx, page_idx))
+		return false;
+
+	/* only plain text pages can be restored into the page buffer */
+	if (ctx->page[page_idx].line_get != top_proc_line_get)
+		return false;
+
+	snap = snapshot_cache_peek(ctx, page_idx);
+
+	return !snap ||
+	       now - snap->stamp >= top_page_interval_get(ctx, page_idx);
+}
+
+/** Get the page to prefetch next
+
+   \return Page index; -1 if all likely pages are cached
+*/
+static int candidate_get(struct top_context *ctx, uint64_t now)
+{
+	struct top_prefetch *pf = &ctx->prefetch;
+	int sel = ctx->page_sel;
+	unsigned int i;
+
+	/* a group key was pressed, one of its pages follows */
+	for (i = 0; ctx->group_key && i < ctx->page_num; i++)
+		if (ctx->page[i].group_key == ctx->group_key &&
+		    candidate_check(ctx, i, now))
+			return i;
+
+	if (candidate_check(ctx, sel + 1, now))
+		return sel + 1;
+
+	if (candidate_check(ctx, sel - 1, now))
+		return sel - 1;
+
+	for (i = 0; i < pf->recent_num; i++)
+		if (candidate_check(ctx, pf->recent[i], now))
+			return pf->recent[i];
+
+	return -1;
+}
+
+/** Load snapshot into the shared buffer
+
+   \return Number of lines
+*/
+static int snapshot_restore(struct top_context *ctx,
+			    const struct top_snapshot *snap,
+			    unsigned int page_idx)
+{
+	char *p = &ctx->shared_buff[0][0];
+	char *end = p + sizeof(ctx->shared_buff);
+	const char *line;
+	size_t len;
+	int i;
+
+	memset(&ctx->line_cache[0], 0, sizeof(ctx->line_cache));
+
+	for (i = 0; i < snap->total && i < TOP_LINE_MAX; i++) {
+		line = top_snapshot_line_get(snap, i);
+		len = strlen(line) + 1;
+		if (len > (size_t)(end - p))
+			break;
+
+		memcpy(p, line, len);
+		ctx->line_cache[i] = p;
+		p += len;
+	}
+
+	/* the page buffer doesn't hold a parsed text anymore */
+	ctx->parsed_size = 0;
+	ctx->fetch_hash = snap->hash;
+	ctx->fetch_reused = false;
+
+	ctx->buff_page = page_idx;
+
+	ctx->page_state[page_idx].total = i;
+	if (ctx->page_state[page_idx].start > i)
+		ctx->page_state[page_idx].start = i;
+
+	return i;
+}
+
+void prefetch_step(struct top_context *ctx)
+{
+	struct top_prefetch *pf = &ctx->prefetch;
+	uint64_t now = top_time_us();
+	int page_idx;
+
+	if (!pf->share)
+		return;
+
+	pf->credit += (now - pf->last) * pf->share / 100;
+	if (pf->credit > TOP_PREFETCH_CREDIT_MAX)
+		pf->credit = TOP_PREFETCH_CREDIT_MAX;
+	pf->last = now;
+
+	if (pf->credit <= 0 || ctx->page_sel >= ctx->page_num ||
+	    ctx->page[ctx->page_sel].line_get != top_proc_line_get)
+		return;
+
+	page_idx = candidate_get(ctx, now / 1000);
+	if (page_idx < 0)
+		return;
+
+	/* the filtered lines of the selected page are left out, they can't
+	   be cached */
+	if (ctx->parsed_size && ctx->parsed_filter)
+		return;
+
+	/* the prefetch overwrites the page buffer of the selected page; it
+	   isn't put into the cache as it would look freshly fetched there */
+	if (top_snapshot_capture(ctx, ctx->page_sel, &pf->stash) < 0)
+		return;
+	pf->stash.hash = ctx->fetch_hash;
+
+	if (counters_fetch(ctx, page_idx) >= 0)
+		(void)snapshot_cache_update(ctx, page_idx);
+	pf->fetches++;
+
+	(void)snapshot_restore(ctx, &pf->stash, ctx->page_sel);
+
+	pf->credit -= top_time_us() - now;
+}
+
+int prefetch_restore(struct top_context *ctx, unsigned int page_idx,
+		     unsigned int max_age)
+{
+	const struct top_snapshot *snap = snapshot_cache_peek(ctx, page_idx);
+
+	if (!snap || top_time_ms() - snap->stamp >= max_age ||
+	    ctx->page[page_idx].line_get != top_proc_line_get)
+		return -1;
+
+	return snapshot_restore(ctx, snap, page_idx);
+}
@@ -0,0 +1,90 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_prefetch_h
+#define __top_prefetch_h
+
+/** Number of recently visited pages kept for the prefetch */
+#define TOP_PREFETCH_RECENT 4
+
+/** Default share (in %) of time spent prefetching */
+#define TOP_PREFETCH_SHARE_DEFAULT 5
+
+/** Maximum prefetch time (in us) saved up while idle */
+#define TOP_PREFETCH_CREDIT_MAX 100000
+
+struct top_context;
+
+/** Prefetch state */
+struct top_prefetch {
+	/** Share (in %) of time spent prefetching; 0 if disabled */
+	unsigned int share;
+	/** Prefetch time (in us) left */
+	int64_t credit;
+	/** Time (in us) of the last credit update */
+	uint64_t last;
+	/** Recently visited pages, most recent first */
+	unsigned int recent[TOP_PREFETCH_RECENT];
+	unsigned int recent_num;
+	/** Page was selected since the last update */
+	bool switched;
+	/** Selected page kept aside while another page is prefetched */
+	struct top_snapshot stash;
+	/** Number of prefetched pages */
+	uint64_t fetches;
+	/** Number of page switches served from the snapshot cache */
+	uint64_t hits;
+};
+
+/** Limit the share of time spent prefetching pages
+
+   Idle time is used to fetch the pages around the selected one and the
+   recently visited ones into the snapshot cache, so they show up without
+   a fetch when selected.
+
+   \param[in] ctx     Context
+   \param[in] percent Maximum share (1..100); 0 to disable prefetching
+*/
+void top_prefetch_share_set(struct top_context *ctx, unsigned int percent);
+
+/** Initialize prefetch state */
+void prefetch_init(struct top_context *ctx);
+
+/** Free prefetch state */
+void prefetch_shutdown(struct top_context *ctx);
+
+/** Record page switch
+
+   \param[in] ctx  Context
+   \param[in] prev Page selected before
+*/
+void prefetch_visit(struct top_context *ctx, unsigned int prev);
+
+/** Check whether a page can be fetched while another one is selected
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page
+*/
+bool prefetch_page_check(struct top_context *ctx, unsigned int page_idx);
+
+/** Prefetch one page if the time budget allows; called while idle */
+void prefetch_step(struct top_context *ctx);
+
+/** Load page from the snapshot cache into the shared buffer instead of
+    fetching it
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page
+   \param[in] max_age  Maximum age (in ms) of the cached snapshot
+
+   \return Number of lines; -1 if there is no usable snapshot
+*/
+int prefetch_restore(struct top_context *ctx, unsigned int page_idx,
+		     unsigned int max_age);
+
+#endif
@@ -0,0 +1,156 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_prof.h"
+
+#include <time.h>
+
+uint64_t top_time_us(void)
+{
+#ifdef ECOS
+	return top_time_ms() * 1000;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+int prof_init(struct top_context *ctx)
+{
+	memset(&ctx->prof, 0, sizeof(ctx->prof));
+
+	ctx->prof.page = calloc(ctx->page_num, sizeof(*ctx->prof.page));
+
+	return ctx->prof.page ? 0 : -1;
+}
+
+void prof_shutdown(struct top_context *ctx)
+{
+	free(ctx->prof.page);
+	ctx->prof.page = NULL;
+}
+
+void top_prof_reset(struct top_context *ctx)
+{
+	if (ctx->prof.page)
+		memset(ctx->prof.page, 0,
+		       sizeof(*ctx->prof.page) * ctx->page_num);
+}
+
+void top_hist_add(struct top_hist *hist, uint64_t us)
+{
+	unsigned int b = 0;
+
+	while (b < TOP_PROF_BUCKETS - 1 && us >= (1ULL << b))
+		b++;
+
+	hist->bucket[b]++;
+	hist->count++;
+	hist->sum += us;
+	if (us > hist->max)
+		hist->max = us > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)us;
+}
+
+void prof_sample(struct top_context *ctx, unsigned int page_idx,
+		 enum top_prof_phase phase, uint64_t us)
+{
+	if (!ctx->prof.page || page_idx >= ctx->page_num)
+		return;
+
+	top_hist_add(&ctx->prof.page[page_idx].hist[phase], us);
+
+	/* the profile page would show its own latency only */
+	if (ctx->page[page_idx].page_get != prof_get)
+		ctx->prof.last = page_idx;
+}
+
+void prof_fetch_start(struct top_context *ctx)
+{
+	ctx->prof.parse = 0;
+	ctx->prof.bytes_read = 0;
+	ctx->prof.syscalls = 0;
+}
+
+void prof_fetch_done(struct top_context *ctx, unsigned int page_idx,
+		     uint64_t us)
+{
+	struct top_prof_page *pp;
+
+	if (!ctx->prof.page)
+		return;
+
+	pp = &ctx->prof.page[page_idx];
+	pp->fetches++;
+	pp->bytes_read += ctx->prof.bytes_read;
+	pp->syscalls += ctx->prof.syscalls;
+	if (ctx->fetch_reused)
+		pp->parse_skips++;
+
+	prof_sample(ctx, page_idx, TOP_PROF_FETCH,
+		    us > ctx->prof.parse ? us - ctx->prof.parse : 0);
+	prof_sample(ctx, page_idx, TOP_PROF_PARSE, ctx->prof.parse);
+}
+
+void prof_frame_skipped(struct top_context *ctx, unsigned int page_idx)
+{
+	if (!ctx->prof.page || page_idx >= ctx->page_num)
+		return;
+
+	ctx->prof.page[page_idx].frame_skips++;
+}
+
+void prof_frame_done(struct top_context *ctx, unsigned int page_idx,
+		     uint64_t filter, uint64_t render, uint64_t bytes)
+{
+	struct top_prof_page *pp;
+
+	if (!ctx->prof.page || page_idx >= ctx->page_num)
+		return;
+
+	pp = &ctx->prof.page[page_idx];
+	pp->frames++;
+	pp->bytes_written += bytes;
+
+	prof_sample(ctx, page_idx, TOP_PROF_FILTER, filter);
+	prof_sample(ctx, page_idx, TOP_PROF_RENDER, render);
+}
+
+void prof_read(struct top_context *ctx, size_t bytes)
+{
+	ctx->prof.bytes_read += bytes;
+	ctx->prof.syscalls++;
+}
+
+uint32_t top_hist_percentile(const struct top_hist *hist, unsigned int pct)
+{
+	uint64_t need, sum = 0;
+	unsigned int b;
+
+	if (!hist->count)
+		return 0;
+
+	need = ((uint64_t)hist->count * pct + 99) / 100;
+
+	for (b = 0; b < TOP_PROF_BUCKETS - 1; b++) {
+		sum += hist->bucket[b];
+		if (sum >= need)
+			break;
+	}
+
+	/* the bucket bound can't be above the worst sample */
+	if (b == TOP_PROF_BUCKETS - 1 || (1U << b) > hist->max)
+		return hist->max;
+
+	return 1U << b;
+}
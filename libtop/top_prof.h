@@ -0,0 +1,154 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_prof_h
+#define __top_prof_h
+
+/** Number of histogram buckets; bucket n counts latencies below 2^n us,
+    the last one everything above */
+#define TOP_PROF_BUCKETS 24
+
+struct top_context;
+
+/** Profiled phases of a refresh */
+enum top_prof_phase {
+	/** Page handler (driver proc handler, read syscalls) */
+	TOP_PROF_FETCH,
+	/** Splitting the page into lines */
+	TOP_PROF_PARSE,
+	/** Applying the filter to the shown lines */
+	TOP_PROF_FILTER,
+	/** Terminal or batch output */
+	TOP_PROF_RENDER,
+	TOP_PROF_PHASE_NUM
+};
+
+/** Latency histogram */
+struct top_hist {
+	uint32_t bucket[TOP_PROF_BUCKETS];
+	/** Number of samples */
+	uint32_t count;
+	/** Sum of all samples (in us) */
+	uint64_t sum;
+	/** Maximum sample (in us) */
+	uint32_t max;
+};
+
+/** Profile of one page */
+struct top_prof_page {
+	struct top_hist hist[TOP_PROF_PHASE_NUM];
+	/** Number of fetches */
+	uint64_t fetches;
+	/** Number of frames drawn or written */
+	uint64_t frames;
+	/** Bytes read by all fetches */
+	uint64_t bytes_read;
+	/** Syscalls issued by all fetches */
+	uint64_t syscalls;
+	/** Bytes written by all frames */
+	uint64_t bytes_written;
+	/** Fetches of a text equal to the last parsed one (parse skipped) */
+	uint64_t parse_skips;
+	/** Periodic frames skipped as the page didn't change */
+	uint64_t frame_skips;
+};
+
+/** Profiling state of a context */
+struct top_prof {
+	/** Per page profile; NULL if out of memory */
+	struct top_prof_page *page;
+	/** Parse time of the running fetch (in us) */
+	uint32_t parse;
+	/** Bytes read by the running fetch */
+	uint32_t bytes_read;
+	/** Syscalls issued by the running fetch */
+	uint32_t syscalls;
+	/** Bytes output by the running frame */
+	uint32_t bytes_written;
+	/** Page profiled last, other than the profile page */
+	unsigned int last;
+};
+
+/** Get monotonic time
+
+   \return Time in us
+*/
+uint64_t top_time_us(void);
+
+/** Allocate per page profile
+
+   \return 0 on success; -1 if out of memory
+*/
+int prof_init(struct top_context *ctx);
+
+/** Release per page profile */
+void prof_shutdown(struct top_context *ctx);
+
+/** Clear all histograms and counters */
+void top_prof_reset(struct top_context *ctx);
+
+/** Add sample to a histogram
+
+   \param[in] hist Histogram
+   \param[in] us   Latency (in us)
+*/
+void top_hist_add(struct top_hist *hist, uint64_t us);
+
+/** Record a sample of a phase
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page
+   \param[in] phase    Phase
+   \param[in] us       Latency (in us)
+*/
+void prof_sample(struct top_context *ctx, unsigned int page_idx,
+		 enum top_prof_phase phase, uint64_t us);
+
+/** Start profiling a fetch */
+void prof_fetch_start(struct top_context *ctx);
+
+/** Finish profiling a fetch
+
+   \param[in] ctx      Context
+   \param[in] page_idx Fetched page
+   \param[in] us       Duration of the fetch including parsing (in us)
+*/
+void prof_fetch_done(struct top_context *ctx, unsigned int page_idx,
+		     uint64_t us);
+
+/** Record a periodic frame skipped for an unchanged page */
+void prof_frame_skipped(struct top_context *ctx, unsigned int page_idx);
+
+/** Record a drawn or written frame
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page
+   \param[in] filter   Time spent filtering (in us)
+   \param[in] render   Time spent on output (in us)
+   \param[in] bytes    Bytes output
+*/
+void prof_frame_done(struct top_context *ctx, unsigned int page_idx,
+		     uint64_t filter, uint64_t render, uint64_t bytes);
+
+/** Account read syscall of the running fetch
+
+   \param[in] ctx   Context
+   \param[in] bytes Bytes returned by the syscall
+*/
+void prof_read(struct top_context *ctx, size_t bytes);
+
+/** Get histogram percentile
+
+   \param[in] hist Histogram
+   \param[in] pct  Percentile (0..100)
+
+   \return Upper bound of the bucket holding the percentile (in us)
+*/
+uint32_t top_hist_percentile(const struct top_hist *hist, unsigned int pct);
+
+#endif
@@ -0,0 +1,222 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_query.h"
+
+/** Cell offset of columns missing in a row */
+#define CELL_NONE 0xFFFFFFFF
+
+const struct top_operations headless_top_ops = {
+	.addstr = NULL,
+};
+
+int top_open(struct top_context *ctx, const struct top_page_desc *page,
+	     unsigned int page_num, top_page_init_t *page_init,
+	     unsigned int page_init_num, void *priv)
+{
+	return top_init(ctx, &headless_top_ops, -1, page, page_num,
+			page_init, page_init_num, 0, NULL, NULL, priv);
+}
+
+void top_close(struct top_context *ctx)
+{
+	top_shutdown(ctx);
+}
+
+void top_query_init(struct top_query *q)
+{
+	memset(q, 0, sizeof(*q));
+}
+
+void top_query_free(struct top_query *q)
+{
+	top_snapshot_free(&q->snap);
+	free(q->text);
+	free(q->cell);
+	memset(q, 0, sizeof(*q));
+}
+
+/** Append cell text
+
+   \return Offset of the text; CELL_NONE if out of memory
+*/
+static unsigned int query_text_add(struct top_query *q, const char *s)
+{
+	size_t len = strlen(s) + 1;
+	unsigned int off;
+
+	if (q->len + len > q->size) {
+		size_t size = q->size ? q->size * 2 : 4096;
+		char *text;
+
+		if (size < q->len + len)
+			size = q->len + len;
+
+		text = realloc(q->text, size);
+		if (!text)
+			return CELL_NONE;
+
+		q->text = text;
+		q->size = size;
+	}
+
+	memcpy(q->text + q->len, s, len);
+	off = q->len;
+	q->len += len;
+
+	return off;
+}
+
+int top_query_fetch(struct top_context *ctx, unsigned int page_idx,
+		    struct top_query *q)
+{
+	char buff[TOP_LINE_LEN];
+	char *col[TOP_COLUMN_MAX];
+	unsigned int need;
+	int i, k, n, row;
+
+	q->rows = 0;
+	q->len = 0;
+
+	if (page_idx >= ctx->page_num || counters_fetch(ctx, page_idx) < 0 ||
+	    top_snapshot_capture(ctx, page_idx, &q->snap) < 0)
+		return -1;
+
+	top_schema_detect(&q->schema, snapshot_table_line_get, &q->snap,
+			  q->snap.total);
+
+	need = (q->snap.total - q->schema.first) * q->schema.cols;
+	if (need > q->cell_max) {
+		unsigned int *cell = realloc(q->cell, sizeof(*cell) * need);
+
+		if (!cell)
+			return -1;
+
+		q->cell = cell;
+		q->cell_max = need;
+	}
+
+	for (i = q->schema.first, row = 0; i < q->snap.total; i++, row++) {
+		unsigned int *c = &q->cell[row * q->schema.cols];
+
+		n = top_columns_split(top_snapshot_line_get(&q->snap, i),
+				      q->schema.sep, buff, col,
+				      q->schema.cols);
+
+		for (k = 0; k < q->schema.cols; k++) {
+			c[k] = k < n ? query_text_add(q, col[k]) : CELL_NONE;
+			if (k < n && c[k] == CELL_NONE)
+				return -1;
+		}
+	}
+
+	q->rows = row;
+
+	return q->rows;
+}
+
+int top_query_rows(const struct top_query *q)
+{
+	return q->rows;
+}
+
+int top_query_cols(const struct top_query *q)
+{
+	return q->schema.cols;
+}
+
+const char *top_query_column_name(const struct top_query *q, int col)
+{
+	if (col < 0 || col >= q->schema.cols)
+		return NULL;
+
+	return q->schema.name[col];
+}
+
+enum top_cell_type top_query_column_type(const struct top_query *q, int col)
+{
+	if (col < 0 || col >= q->schema.cols)
+		return TOP_CELL_NONE;
+
+	return q->schema.type[col];
+}
+
+int top_query_column_find(const struct top_query *q, const char *name)
+{
+	int k;
+
+	if (name[0] == '#') {
+		k = atoi(name + 1) - 1;
+		return k >= 0 && k < q->schema.cols ? k : -1;
+	}
+
+	for (k = 0; k < q->schema.cols; k++)
+		if (strcmp(q->schema.name[k], name) == 0)
+			return k;
+
+	return -1;
+}
+
+const char *top_query_cell(const struct top_query *q, int row, int col)
+{
+	unsigned int off;
+
+	if (row < 0 || row >= q->rows || col < 0 || col >= q->schema.cols)
+		return NULL;
+
+	off = q->cell[row * q->schema.cols + col];
+
+	return off == CELL_NONE ? NULL : q->text + off;
+}
+
+int top_query_row_find(const struct top_query *q, const char *key)
+{
+	const char *cell;
+	int i;
+
+	for (i = 0; i < q->rows; i++) {
+		cell = top_query_cell(q, i, 0);
+		if (cell && strcmp(cell, key) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+int top_query_cell_num(const struct top_query *q, int row, int col,
+		       double *value)
+{
+	const char *cell = top_query_cell(q, row, col);
+
+	if (!cell)
+		return -1;
+
+	return top_cell_num(cell, value);
+}
+
+int top_query_cell_int(const struct top_query *q, int row, int col,
+		       long long *value)
+{
+	const char *cell = top_query_cell(q, row, col);
+
+	if (!cell || top_cell_type_get(cell) != TOP_CELL_INT)
+		return -1;
+
+	while (isspace((unsigned char)*cell))
+		cell++;
+
+	if (cell[0] == '0' && (cell[1] == 'x' || cell[1] == 'X'))
+		*value = (long long)strtoull(cell + 2, NULL, 16);
+	else
+		*value = strtoll(cell, NULL, 10);
+
+	return 0;
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_query_h
+#define __top_query_h
+
+#include "top.h"
+#include "top_table.h"
+
+/** Parsed page, reused by repeated queries
+
+   All buffers only grow, so polling the same pages again doesn't allocate
+   memory once the largest page was seen.
+*/
+struct top_query {
+	/** Captured page */
+	struct top_snapshot snap;
+	/** Column names and types */
+	struct top_schema schema;
+	/** Number of data rows */
+	int rows;
+	/** Cell texts, NUL terminated */
+	char *text;
+	/** Used bytes of text */
+	size_t len;
+	/** Size of text */
+	size_t size;
+	/** Offset of each cell in text, rows * schema.cols entries */
+	unsigned int *cell;
+	/** Number of entries in cell */
+	unsigned int cell_max;
+};
+
+/** Operations of a context without terminal */
+extern const struct top_operations headless_top_ops;
+
+/** Initialize context for queries only (no terminal, no batch output)
+
+   \param[in] ctx           Context
+   \param[in] page          Pages
+   \param[in] page_num      Number of pages
+   \param[in] page_init     Page group initialization handlers
+   \param[in] page_init_num Number of page_init handlers
+   \param[in] priv          Private data of the pages
+
+   \return 0 on success; -1 on error
+*/
+int top_open(struct top_context *ctx, const struct top_page_desc *page,
+	     unsigned int page_num, top_page_init_t *page_init,
+	     unsigned int page_init_num, void *priv);
+
+/** Release context opened with \ref top_open */
+void top_close(struct top_context *ctx);
+
+/** Initialize query (no memory is allocated until the first fetch) */
+void top_query_init(struct top_query *q);
+
+/** Release query buffers */
+void top_query_free(struct top_query *q);
+
+/** Fetch page and parse it into the query
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page (see top_page_find)
+   \param[in] q        Query, contents of a previous fetch are replaced
+
+   \return Number of data rows; -1 on error
+*/
+int top_query_fetch(struct top_context *ctx, unsigned int page_idx,
+		    struct top_query *q);
+
+/** Get number of data rows */
+int top_query_rows(const struct top_query *q);
+
+/** Get number of columns */
+int top_query_cols(const struct top_query *q);
+
+/** Get column name */
+const char *top_query_column_name(const struct top_query *q, int col);
+
+/** Get column type (widest type of all cells of the column) */
+enum top_cell_type top_query_column_type(const struct top_query *q, int col);
+
+/** Find column by name or "#<n>"
+
+   \return Column index; -1 if not found
+*/
+int top_query_column_find(const struct top_query *q, const char *name);
+
+/** Find row by key (text of the first column)
+
+   \return Row index; -1 if not found
+*/
+int top_query_row_find(const struct top_query *q, const char *key);
+
+/** Get cell text
+
+   \return Cell text; NULL if the cell doesn't exist
+*/
+const char *top_query_cell(const struct top_query *q, int row, int col);
+
+/** Get numeric value of a cell
+
+   \return 0 on success; -1 if the cell doesn't exist or is not numeric
+*/
+int top_query_cell_num(const struct top_query *q, int row, int col,
+		       double *value);
+
+/** Get integer value of a cell (decimal or 0x prefixed hex)
+
+   \return 0 on success; -1 if the cell doesn't exist or is not an integer
+*/
+int top_query_cell_int(const struct top_query *q, int row, int col,
+		       long long *value);
+
+#endif
@@ -0,0 +1,167 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_record.h"
+
+static void record_addstr(struct top_context *ctx, const char *s)
+{
+	struct top_record *rec = ctx->priv;
+
+	rec->calls[TOP_RECORD_ADDSTR]++;
+	rec->bytes += strlen(s);
+}
+
+static void record_clrtoeol(struct top_context *ctx)
+{
+	struct top_record *rec = ctx->priv;
+
+	rec->calls[TOP_RECORD_CLRTOEOL]++;
+}
+
+static void record_clear(struct top_context *ctx)
+{
+	struct top_record *rec = ctx->priv;
+
+	rec->calls[TOP_RECORD_CLEAR]++;
+}
+
+static void record_move(struct top_context *ctx, int y, int x)
+{
+	struct top_record *rec = ctx->priv;
+
+	rec->calls[TOP_RECORD_MOVE]++;
+}
+
+static void record_scroll(struct top_context *ctx, int top, int bottom,
+			  int n)
+{
+	struct top_record *rec = ctx->priv;
+
+	rec->calls[TOP_RECORD_SCROLL]++;
+}
+
+static int record_getch(struct top_context *ctx)
+{
+	struct top_record *rec = ctx->priv;
+
+	rec->calls[TOP_RECORD_GETCH]++;
+
+	if (rec->key_pos >= rec->key_num)
+		return KEY_CTRL_C;
+
+	if (!rec->key_time)
+		rec->key_time = top_time_us();
+
+	return (unsigned char)rec->key[rec->key_pos++];
+}
+
+static int record_input(struct top_context *ctx, char *buf, size_t size)
+{
+	struct top_record *rec = ctx->priv;
+	size_t num = rec->key_num - rec->key_pos;
+
+	if (!num || !rec->burst) {
+		buf[0] = (char)record_getch(ctx);
+		return 1;
+	}
+
+	rec->calls[TOP_RECORD_GETCH]++;
+
+	if (!rec->key_time)
+		rec->key_time = top_time_us();
+
+	if (num > size)
+		num = size;
+
+	memcpy(buf, rec->key + rec->key_pos, num);
+	rec->key_pos += num;
+
+	return (int)num;
+}
+
+static int record_hasch(struct top_context *ctx)
+{
+	struct top_record *rec = ctx->priv;
+
+	rec->calls[TOP_RECORD_HASCH]++;
+
+	/* the main loop ends with the KEY_CTRL_C after the script */
+	return 1;
+}
+
+static void record_terminal_size_get(struct top_context *ctx)
+{
+	struct top_record *rec = ctx->priv;
+
+	ctx->rows = rec->rows;
+	ctx->cols = rec->cols;
+}
+
+static void record_attr(struct top_context *ctx, int attr)
+{
+	struct top_record *rec = ctx->priv;
+
+	rec->calls[TOP_RECORD_ATTR]++;
+}
+
+static void record_refresh(struct top_context *ctx)
+{
+	struct top_record *rec = ctx->priv;
+
+	rec->calls[TOP_RECORD_REFRESH]++;
+	rec->frames++;
+
+	if (rec->key_time) {
+		top_hist_add(&rec->latency, top_time_us() - rec->key_time);
+		rec->key_time = 0;
+	}
+}
+
+const struct top_operations record_top_ops = {
+	.addstr = record_addstr,
+	.clrtoeol = record_clrtoeol,
+	.clear = record_clear,
+	.move = record_move,
+	.getch = record_getch,
+	.hasch = record_hasch,
+	.input = record_input,
+	.terminal_size_get = record_terminal_size_get,
+	.attron = record_attr,
+	.attroff = record_attr,
+	.refresh = record_refresh,
+	.scroll = record_scroll,
+};
+
+void top_record_init(struct top_record *rec, unsigned int rows,
+		     unsigned int cols)
+{
+	memset(rec, 0, sizeof(*rec));
+	rec->rows = rows;
+	rec->cols = cols;
+}
+
+void top_record_keys(struct top_record *rec, const char *key, size_t num)
+{
+	rec->key = key;
+	rec->key_num = num;
+	rec->key_pos = 0;
+	rec->key_time = 0;
+	rec->burst = false;
+}
+
+void top_record_reset(struct top_record *rec)
+{
+	memset(rec->calls, 0, sizeof(rec->calls));
+	memset(&rec->latency, 0, sizeof(rec->latency));
+	rec->bytes = 0;
+	rec->frames = 0;
+	rec->key_time = 0;
+}
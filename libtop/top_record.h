@@ -0,0 +1,76 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_record_h
+#define __top_record_h
+
+#include "top_prof.h"
+
+/** Operations counted by the recording backend */
+enum top_record_op {
+	TOP_RECORD_ADDSTR,
+	TOP_RECORD_CLRTOEOL,
+	TOP_RECORD_CLEAR,
+	TOP_RECORD_MOVE,
+	TOP_RECORD_GETCH,
+	TOP_RECORD_HASCH,
+	TOP_RECORD_REFRESH,
+	TOP_RECORD_ATTR,
+	TOP_RECORD_SCROLL,
+	TOP_RECORD_OP_NUM
+};
+
+/** State of the recording backend; ctx->priv has to point to it */
+struct top_record {
+	/** Terminal size reported to the context */
+	unsigned int rows, cols;
+	/** Calls of each operation */
+	uint64_t calls[TOP_RECORD_OP_NUM];
+	/** Bytes passed to addstr */
+	uint64_t bytes;
+	/** Frames (refresh calls) */
+	uint64_t frames;
+	/** Scripted input; KEY_CTRL_C is returned once it is consumed */
+	const char *key;
+	size_t key_num;
+	size_t key_pos;
+	/** Reads return all scripted input at once instead of byte by byte */
+	bool burst;
+	/** Time (in us) the first key after the last frame was read */
+	uint64_t key_time;
+	/** Keypress-to-frame latency */
+	struct top_hist latency;
+};
+
+/** Terminal operations which count the calls and bytes instead of drawing
+
+   ctx->priv has to point to a struct top_record.
+*/
+extern const struct top_operations record_top_ops;
+
+/** Initialize recording backend
+
+   \param[in] rec  Backend state
+   \param[in] rows Terminal rows
+   \param[in] cols Terminal columns
+*/
+void top_record_init(struct top_record *rec, unsigned int rows,
+		     unsigned int cols);
+
+/** Set scripted input
+
+   \param[in] rec Backend state
+   \param[in] key Raw input bytes (escape sequences included)
+   \param[in] num Number of bytes
+*/
+void top_record_keys(struct top_record *rec, const char *key, size_t num);
+
+/** Clear the counters, keep the input and the terminal size */
+void top_record_reset(struct top_record *rec);
+
+#endif
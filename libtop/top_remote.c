@@ -0,0 +1,242 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_server.h"
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/** Local copy of a server page */
+struct remote_page {
+	/** Server state the copy belongs to */
+	unsigned int epoch;
+	unsigned int seq;
+	/** Number of lines (without header) */
+	int total;
+	/** Line texts; entry 0 is the header */
+	char **line;
+	/** Size of line */
+	unsigned int size;
+};
+
+struct top_remote {
+	int fd;
+	/** Reply stream */
+	FILE *in;
+	struct remote_page *page;
+};
+
+int top_remote_attach(struct top_context *ctx, const char *path)
+{
+	struct top_remote *rm;
+	struct sockaddr_un addr;
+	struct timeval tv;
+
+	if (ctx->remote || strlen(path) >= sizeof(addr.sun_path))
+		return -1;
+
+	rm = malloc(sizeof(*rm));
+	if (!rm)
+		return -1;
+
+	memset(rm, 0, sizeof(*rm));
+	rm->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (rm->fd < 0) {
+		free(rm);
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	tv.tv_sec = TOP_REMOTE_TIMEOUT / 1000;
+	tv.tv_usec = TOP_REMOTE_TIMEOUT % 1000 * 1000;
+
+	if (connect(rm->fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+	    setsockopt(rm->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv))) {
+		close(rm->fd);
+		free(rm);
+		return -1;
+	}
+
+	rm->page = calloc(ctx->page_num, sizeof(*rm->page));
+	rm->in = fdopen(rm->fd, "r");
+	if (!rm->page || !rm->in) {
+		if (rm->in)
+			fclose(rm->in);
+		else
+			close(rm->fd);
+		free(rm->page);
+		free(rm);
+		return -1;
+	}
+
+	ctx->remote = rm;
+
+	return 0;
+}
+
+void top_remote_detach(struct top_context *ctx)
+{
+	struct top_remote *rm = ctx->remote;
+	unsigned int i, k;
+
+	if (!rm)
+		return;
+
+	for (i = 0; i < ctx->page_num; i++) {
+		for (k = 0; k < rm->page[i].size; k++)
+			free(rm->page[i].line[k]);
+		free(rm->page[i].line);
+	}
+
+	fclose(rm->in);
+	free(rm->page);
+	free(rm);
+	ctx->remote = NULL;
+}
+
+/** Resize local page copy
+
+   \return 0 on success; -1 if out of memory
+*/
+static int page_resize(struct remote_page *p, int total)
+{
+	unsigned int size = total + 1;
+	unsigned int k;
+
+	for (k = size; k < p->size; k++) {
+		free(p->line[k]);
+		p->line[k] = NULL;
+	}
+
+	if (size > p->size) {
+		char **line = realloc(p->line, sizeof(*line) * size);
+
+		if (!line)
+			return -1;
+
+		for (k = p->size; k < size; k++)
+			line[k] = NULL;
+
+		p->line = line;
+		p->size = size;
+	}
+
+	p->total = total;
+
+	return 0;
+}
+
+/** Send request for a page and update the local copy with the reply
+
+   \return 0 on success; 1 if the server couldn't serve the page; -1 on
+           error
+*/
+static int page_request(struct top_context *ctx, unsigned int page_idx)
+{
+	struct top_remote *rm = ctx->remote;
+	struct remote_page *p = &rm->page[page_idx];
+	char buff[TOP_LINE_LEN + 32];
+	unsigned int epoch, seq, count;
+	int len, total, line, off;
+	char *text;
+
+	len = snprintf(buff, sizeof(buff), "GET %u %u %s\n", p->epoch, p->seq,
+		       ctx->page[page_idx].name);
+	if (len >= (int)sizeof(buff) ||
+	    send(rm->fd, buff, len, MSG_NOSIGNAL) != len)
+		return -1;
+
+	if (!fgets(buff, sizeof(buff), rm->in))
+		return -1;
+
+	/* the reply is a single line, the stream stays in sync */
+	if (strncmp(buff, "ERR ", 4) == 0)
+		return 1;
+
+	if (sscanf(buff, "PAGE %u %u %d %u", &epoch, &seq, &total,
+		   &count) != 4 || total < 0 || total > TOP_LINE_MAX)
+		return -1;
+
+	/* a full copy follows if the server doesn't know our state */
+	if (page_resize(p, total))
+		return -1;
+
+	while (count--) {
+		if (!fgets(buff, sizeof(buff), rm->in))
+			return -1;
+
+		buff[strcspn(buff, "\n")] = 0;
+		off = 0;
+		if (sscanf(buff, "%d %n", &line, &off) != 1 || !off ||
+		    line < -1 || line >= total)
+			return -1;
+
+		text = strdup(buff + off);
+		if (!text)
+			return -1;
+
+		free(p->line[line + 1]);
+		p->line[line + 1] = text;
+	}
+
+	p->epoch = epoch;
+	p->seq = seq;
+
+	return 0;
+}
+
+int remote_fetch(struct top_context *ctx, unsigned int page_idx)
+{
+	char *text = &ctx->shared_buff[0][0];
+	struct remote_page *p;
+	const char *line;
+	size_t s = 0, n;
+	int i, ret;
+
+	/* only plain text pages can be copied into the page buffer */
+	if (ctx->page[page_idx].line_get != top_proc_line_get)
+		return -1;
+
+	ret = page_request(ctx, page_idx);
+	if (ret < 0) {
+		/* the reply stream is out of sync, read locally from now on */
+		top_remote_detach(ctx);
+		return -1;
+	}
+
+	/* failed like a local read of the page */
+	if (ret)
+		return linux_text_parse(ctx, 0);
+
+	p = &ctx->remote->page[page_idx];
+
+	/* the text is parsed like a local read, so the page hash and the
+	 * filter pushdown work the same */
+	for (i = 0; i < p->total; i++) {
+		line = p->line[i + 1] ? p->line[i + 1] : "";
+		n = strlen(line);
+		if (s + n + 1 > sizeof(ctx->shared_buff))
+			break;
+
+		memcpy(text + s, line, n);
+		s += n;
+		text[s++] = '\n';
+	}
+
+	return linux_text_parse(ctx, s);
+}
+
+#endif
@@ -0,0 +1,361 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_screen.h"
+
+#include <limits.h>
+
+#define opt(p) if (p) p
+
+static void screen_free(struct top_screen *s)
+{
+	free(s->shown);
+	free(s->shown_attr);
+	free(s->next);
+	free(s->next_attr);
+	s->shown = s->next = NULL;
+	s->shown_attr = s->next_attr = NULL;
+	s->rows = s->cols = 0;
+}
+
+/** Resize the screens to the terminal; the terminal contents are unknown
+    then */
+static int screen_resize(struct top_context *ctx, struct top_screen *s)
+{
+	size_t size = (size_t)ctx->rows * ctx->cols;
+
+	screen_free(s);
+
+	s->shown = calloc(size, 1);
+	s->shown_attr = calloc(size, 1);
+	s->next = malloc(size);
+	s->next_attr = calloc(size, 1);
+	if (!s->shown || !s->shown_attr || !s->next || !s->next_attr) {
+		screen_free(s);
+		return -1;
+	}
+
+	memset(s->next, ' ', size);
+	s->rows = ctx->rows;
+	s->cols = ctx->cols;
+
+	return 0;
+}
+
+int top_line_rate_set(struct top_context *ctx, unsigned int baud)
+{
+	struct top_screen *s = ctx->screen;
+
+	if (!baud) {
+		screen_shutdown(ctx);
+		return 0;
+	}
+
+	if (!s) {
+		s = calloc(1, sizeof(*s));
+		if (!s)
+			return -1;
+
+		ctx->screen = s;
+	}
+
+	s->rate = baud / 10 ? baud / 10 : 1;
+
+	/* the line is idle; a full burst may be sent right away */
+	s->credit = (int64_t)s->rate * TOP_SCREEN_BURST / 1000;
+	s->last = top_time_us();
+
+	return 0;
+}
+
+int screen_begin(struct top_context *ctx, unsigned int focus_top,
+		 unsigned int focus_height)
+{
+	struct top_screen *s = ctx->screen;
+
+	if ((s->rows != ctx->rows || s->cols != ctx->cols) &&
+	    screen_resize(ctx, s))
+		return -1;
+
+	memset(s->next, ' ', (size_t)s->rows * s->cols);
+	memset(s->next_attr, 0, (size_t)s->rows * s->cols);
+	s->y = s->x = 0;
+	s->attr = 0;
+	s->frame = true;
+
+	/* the footer isn't part of a pane */
+	s->focus_top = focus_top < s->rows - 1 ? focus_top : s->rows - 1;
+	s->focus_height = focus_height < s->rows - 1 - s->focus_top ?
+			  focus_height : s->rows - 1 - s->focus_top;
+
+	return 0;
+}
+
+void screen_move(struct top_context *ctx, int y, int x)
+{
+	struct top_screen *s = ctx->screen;
+
+	s->y = y < 0 ? 0 : y;
+	s->x = x < 0 ? 0 : x;
+}
+
+void screen_addstr(struct top_context *ctx, const char *str)
+{
+	struct top_screen *s = ctx->screen;
+	size_t cell;
+
+	for (; *str; str++) {
+		/* long lines continue on the next row */
+		if (s->x >= s->cols) {
+			s->x = 0;
+			s->y++;
+		}
+
+		if (s->y >= s->rows)
+			return;
+
+		cell = (size_t)s->y * s->cols + s->x++;
+		s->next[cell] = *str;
+		s->next_attr[cell] = s->attr;
+	}
+}
+
+void screen_clrtoeol(struct top_context *ctx)
+{
+	struct top_screen *s = ctx->screen;
+	size_t cell = (size_t)s->y * s->cols + s->x;
+
+	if (s->y >= s->rows || s->x >= s->cols)
+		return;
+
+	memset(s->next + cell, ' ', s->cols - s->x);
+	memset(s->next_attr + cell, 0, s->cols - s->x);
+}
+
+void screen_attron(struct top_context *ctx, int attr)
+{
+	ctx->screen->attr |= 1 << attr;
+}
+
+void screen_attroff(struct top_context *ctx, int attr)
+{
+	ctx->screen->attr &= ~(1 << attr);
+}
+
+/** Switch the terminal attributes
+
+   \return Estimated number of bytes sent
+*/
+static unsigned int attr_set(struct top_context *ctx, uint8_t cur,
+			     uint8_t attr)
+{
+	unsigned int bytes = 0;
+	int i;
+
+	/* the terminal switches all attributes off at once */
+	if (cur & ~attr) {
+		opt(ctx->ops->attroff)(ctx, A_UNDERLINE);
+		bytes += TOP_SCREEN_SEQ_LEN;
+		cur = 0;
+	}
+
+	for (i = 0; i < 8; i++) {
+		if (!(attr & ~cur & (1 << i)))
+			continue;
+
+		opt(ctx->ops->attron)(ctx, i);
+		bytes += TOP_SCREEN_SEQ_LEN;
+	}
+
+	return bytes;
+}
+
+/** Send the changed cells of a row
+
+   \return Estimated number of bytes sent; 0 if the row is unchanged
+*/
+static unsigned int row_flush(struct top_context *ctx, struct top_screen *s,
+			      unsigned int y)
+{
+	const char *next = s->next + (size_t)y * s->cols;
+	const uint8_t *next_attr = s->next_attr + (size_t)y * s->cols;
+	char *shown = s->shown + (size_t)y * s->cols;
+	uint8_t *shown_attr = s->shown_attr + (size_t)y * s->cols;
+	unsigned int first, last, end, x, run, bytes;
+	char buff[TOP_LINE_LEN];
+	uint8_t attr = 0;
+
+	for (first = 0; first < s->cols; first++)
+		if (next[first] != shown[first] ||
+		    next_attr[first] != shown_attr[first])
+			break;
+
+	if (first == s->cols)
+		return 0;
+
+	for (last = s->cols - 1; last > first; last--)
+		if (next[last] != shown[last] ||
+		    next_attr[last] != shown_attr[last])
+			break;
+
+	/* a blank tail is cleared instead of written */
+	for (end = s->cols; end > first; end--)
+		if (next[end - 1] != ' ' || next_attr[end - 1])
+			break;
+
+	/* writing the last cell may scroll the terminal */
+	if (y == s->rows - 1 && last == s->cols - 1 && end == s->cols)
+		end--;
+
+	ctx->ops->move(ctx, y, first);
+	bytes = TOP_SCREEN_SEQ_LEN;
+
+	for (x = first; x <= last && x < end; x += run) {
+		if (next_attr[x] != attr) {
+			bytes += attr_set(ctx, attr, next_attr[x]);
+			attr = next_attr[x];
+		}
+
+		for (run = 0; x + run <= last && x + run < end &&
+		     next_attr[x + run] == attr &&
+		     run < sizeof(buff) - 1; run++)
+			buff[run] = next[x + run];
+		buff[run] = 0;
+
+		ctx->ops->addstr(ctx, buff);
+		bytes += run;
+	}
+
+	if (attr)
+		bytes += attr_set(ctx, attr, 0);
+
+	if (last >= end) {
+		ctx->ops->clrtoeol(ctx);
+		bytes += TOP_SCREEN_SEQ_LEN;
+		last = s->cols - 1;
+	}
+
+	memcpy(shown + first, next + first, last - first + 1);
+	memcpy(shown_attr + first, next_attr + first, last - first + 1);
+
+	return bytes;
+}
+
+/** Get the row sent i-th: the footer, the focused pane, then the other rows
+    top down */
+static unsigned int row_order(const struct top_screen *s, unsigned int i)
+{
+	if (i == 0)
+		return s->rows - 1;
+
+	i--;
+	if (i < s->focus_height)
+		return s->focus_top + i;
+
+	i -= s->focus_height;
+	if (i < s->focus_top)
+		return i;
+
+	return i + s->focus_height;
+}
+
+/** Update the bytes the line rate allows to send */
+static void credit_update(struct top_screen *s)
+{
+	uint64_t now = top_time_us();
+	int64_t max = (int64_t)s->rate * TOP_SCREEN_BURST / 1000;
+
+	s->credit += (int64_t)((now - s->last) * s->rate / 1000000);
+	if (s->credit > max)
+		s->credit = max;
+	s->last = now;
+}
+
+uint64_t screen_flush(struct top_context *ctx)
+{
+	struct top_screen *s = ctx->screen;
+	unsigned int i, bytes;
+	uint64_t sent = 0;
+
+	if (!s->rows)
+		return 0;
+
+	credit_update(s);
+
+	for (i = 0; i < s->rows && s->credit > 0; i++) {
+		bytes = row_flush(ctx, s, row_order(s, i));
+
+		s->credit -= bytes;
+		sent += bytes;
+	}
+
+	s->pending = memcmp(s->shown, s->next, (size_t)s->rows * s->cols) ||
+		     memcmp(s->shown_attr, s->next_attr,
+			    (size_t)s->rows * s->cols);
+
+	if (s->frame && s->pending) {
+		if (sent)
+			s->partial++;
+		else
+			s->dropped++;
+	}
+	s->frame = false;
+
+	ctx->prof.bytes_written += sent;
+
+	return sent;
+}
+
+unsigned int screen_wait(struct top_context *ctx)
+{
+	struct top_screen *s = ctx->screen;
+
+	if (!s || !s->pending)
+		return UINT_MAX;
+
+	credit_update(s);
+	if (s->credit > 0)
+		return 0;
+
+	return (unsigned int)((1 - s->credit) * 1000 / s->rate) + 1;
+}
+
+bool screen_pending(struct top_context *ctx)
+{
+	return screen_wait(ctx) == 0;
+}
+
+void screen_invalidate(struct top_context *ctx, unsigned int row,
+		       unsigned int num)
+{
+	struct top_screen *s = ctx->screen;
+
+	if (!s || row >= s->rows)
+		return;
+
+	if (num > s->rows - row)
+		num = s->rows - row;
+
+	memset(s->shown + (size_t)row * s->cols, 0, (size_t)num * s->cols);
+	s->pending = true;
+}
+
+void screen_shutdown(struct top_context *ctx)
+{
+	struct top_screen *s = ctx->screen;
+
+	if (!s)
+		return;
+
+	screen_free(s);
+	free(s);
+	ctx->screen = NULL;
+}
@@ -0,0 +1,113 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_screen_h
+#define __top_screen_h
+
+/** Longest output burst (in ms of the line rate) a flush may send */
+#define TOP_SCREEN_BURST 200
+
+/** Estimated bytes of a cursor move, an attribute change or a line clear */
+#define TOP_SCREEN_SEQ_LEN 8
+
+struct top_context;
+
+/** Shadow screen of a terminal with limited line rate */
+struct top_screen {
+	/** Output rate (in bytes per second) */
+	unsigned int rate;
+	/** Size of the screens */
+	unsigned int rows, cols;
+	/** Cells shown on the terminal; text 0 if unknown */
+	char *shown;
+	uint8_t *shown_attr;
+	/** Cells of the last composed frame */
+	char *next;
+	uint8_t *next_attr;
+	/** Composing position and attributes */
+	unsigned int y, x;
+	uint8_t attr;
+	/** Rows sent first; the focused pane */
+	unsigned int focus_top, focus_height;
+	/** Bytes allowed to be sent */
+	int64_t credit;
+	/** Time (in us) of the last credit update */
+	uint64_t last;
+	/** Shown cells differ from the last frame */
+	bool pending;
+	/** No flush since the frame was composed */
+	bool frame;
+
+	/** Number of frames of which nothing was sent right away */
+	uint64_t dropped;
+	/** Number of frames sent only partially right away */
+	uint64_t partial;
+};
+
+/** Limit the terminal output to a line rate
+
+   Frames are composed on a shadow screen; only the cells that differ from
+   the terminal are sent, within the bytes the line rate allows. Rows that
+   don't fit are sent later, the focused pane and the footer first, and
+   frames composed meanwhile replace them.
+
+   \param[in] ctx  Context
+   \param[in] baud Line rate (in bit/s, 10 bits per byte); 0 to draw every
+                   frame as a whole
+
+   \return 0 on success; -1 if out of memory
+*/
+int top_line_rate_set(struct top_context *ctx, unsigned int baud);
+
+/** Start composing frame
+
+   \param[in] ctx          Context
+   \param[in] focus_top    First row of the focused pane
+   \param[in] focus_height Rows of the focused pane
+
+   \return 0 on success; -1 if out of memory
+*/
+int screen_begin(struct top_context *ctx, unsigned int focus_top,
+		 unsigned int focus_height);
+
+void screen_move(struct top_context *ctx, int y, int x);
+void screen_addstr(struct top_context *ctx, const char *s);
+void screen_clrtoeol(struct top_context *ctx);
+void screen_attron(struct top_context *ctx, int attr);
+void screen_attroff(struct top_context *ctx, int attr);
+
+/** Send the changed cells of the frame the line rate allows
+
+   \return Number of bytes sent
+*/
+uint64_t screen_flush(struct top_context *ctx);
+
+/** Check whether cells of the last frame are still to be sent and the line
+    rate allows it */
+bool screen_pending(struct top_context *ctx);
+
+/** Get time (in ms) until the line rate allows to send the rest of the
+    last frame
+
+   \return 0 if cells can be sent now; UINT_MAX if all cells were sent
+*/
+unsigned int screen_wait(struct top_context *ctx);
+
+/** Forget contents of terminal rows drawn around the shadow screen
+
+   \param[in] ctx   Context
+   \param[in] row   First row
+   \param[in] num   Number of rows
+*/
+void screen_invalidate(struct top_context *ctx, unsigned int row,
+		       unsigned int num);
+
+/** Release shadow screen */
+void screen_shutdown(struct top_context *ctx);
+
+#endif
@@ -0,0 +1,166 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_search.h"
+
+/** Number of words of a trigram filter */
+#define SEARCH_BLOOM_WORDS ((1U << TOP_SEARCH_BLOOM_ORDER) / 64)
+
+/** Trigram filter of a page snapshot */
+struct search_index {
+	/** Snapshot generation and text hash the filter was built from */
+	uint32_t gen;
+	uint64_t hash;
+	bool valid;
+	uint64_t bloom[SEARCH_BLOOM_WORDS];
+};
+
+struct top_search {
+	struct search_index *index;
+	/** Pages scanned by the last search */
+	unsigned int scanned;
+};
+
+/** Get the two filter bits of a trigram */
+static void trigram_bits(const char *p, unsigned int bit[2])
+{
+	uint32_t t = (uint32_t)(unsigned char)p[0] << 16 |
+		     (uint32_t)(unsigned char)p[1] << 8 |
+		     (uint32_t)(unsigned char)p[2];
+
+	bit[0] = (t * 2654435761U) >> (32 - TOP_SEARCH_BLOOM_ORDER);
+	bit[1] = (t * 2246822519U) >> (32 - TOP_SEARCH_BLOOM_ORDER);
+}
+
+static void bloom_add(uint64_t *bloom, const char *text)
+{
+	unsigned int bit[2];
+
+	for (; text[0] && text[1] && text[2]; text++) {
+		trigram_bits(text, bit);
+		bloom[bit[0] / 64] |= 1ULL << (bit[0] % 64);
+		bloom[bit[1] / 64] |= 1ULL << (bit[1] % 64);
+	}
+}
+
+/** Check whether all trigrams of a text are in the filter */
+static bool bloom_check(const uint64_t *bloom, const char *text)
+{
+	unsigned int bit[2];
+
+	for (; text[0] && text[1] && text[2]; text++) {
+		trigram_bits(text, bit);
+		if (!(bloom[bit[0] / 64] & (1ULL << (bit[0] % 64))) ||
+		    !(bloom[bit[1] / 64] & (1ULL << (bit[1] % 64))))
+			return false;
+	}
+
+	return true;
+}
+
+static struct top_search *search_get(struct top_context *ctx)
+{
+	struct top_search *s = ctx->search;
+
+	if (s)
+		return s;
+
+	s = calloc(1, sizeof(*s));
+	if (!s)
+		return NULL;
+
+	s->index = calloc(ctx->page_num, sizeof(*s->index));
+	if (!s->index) {
+		free(s);
+		return NULL;
+	}
+
+	ctx->search = s;
+
+	return s;
+}
+
+/** Rebuild the filter of a page if its snapshot changed */
+static void index_update(struct search_index *idx,
+			 const struct top_snapshot *snap)
+{
+	int i;
+
+	if (idx->valid && idx->gen == snap->gen && idx->hash == snap->hash)
+		return;
+
+	memset(idx->bloom, 0, sizeof(idx->bloom));
+	for (i = 0; i < snap->total; i++)
+		bloom_add(idx->bloom, top_snapshot_line_get(snap, i));
+
+	idx->gen = snap->gen;
+	idx->hash = snap->hash;
+	idx->valid = true;
+}
+
+int top_search(struct top_context *ctx, const char *text,
+	       struct top_search_result *result, unsigned int max)
+{
+	struct top_search *s = search_get(ctx);
+	const struct top_snapshot *snap;
+	unsigned int i, num = 0;
+	int line;
+
+	if (!s || !text[0])
+		return -1;
+
+	s->scanned = 0;
+
+	for (i = 0; i < ctx->page_num && num < max; i++) {
+		/* pages depending on being selected aren't fetched */
+		if (i == ctx->page_sel ? !ctx->page[i].line_get :
+					 !prefetch_page_check(ctx, i))
+			continue;
+
+		snap = snapshot_cache_get(ctx, i, top_page_interval_get(ctx, i));
+		if (!snap)
+			continue;
+
+		index_update(&s->index[i], snap);
+		if (!bloom_check(s->index[i].bloom, text))
+			continue;
+
+		s->scanned++;
+
+		for (line = 0; line < snap->total && num < max; line++) {
+			if (!strstr(top_snapshot_line_get(snap, line), text))
+				continue;
+
+			result[num].page_idx = i;
+			result[num].line = line;
+			num++;
+		}
+	}
+
+	return (int)num;
+}
+
+unsigned int top_search_scanned_get(struct top_context *ctx)
+{
+	return ctx->search ? ctx->search->scanned : 0;
+}
+
+void search_shutdown(struct top_context *ctx)
+{
+	struct top_search *s = ctx->search;
+
+	if (!s)
+		return;
+
+	free(s->index);
+	free(s);
+	ctx->search = NULL;
+}
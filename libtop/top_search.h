@@ -0,0 +1,52 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_search_h
+#define __top_search_h
+
+/** Size (as power of two, in bits) of the trigram filter of a page */
+#define TOP_SEARCH_BLOOM_ORDER 14
+
+/** Maximum number of search results shown */
+#define TOP_SEARCH_RESULT_MAX 256
+
+struct top_context;
+
+/** Search match */
+struct top_search_result {
+	/** Page of the line */
+	unsigned int page_idx;
+	/** Line number */
+	int line;
+};
+
+/** Search the latest snapshots of all pages for a text
+
+   Pages whose snapshot is older than their update interval are fetched.
+   Each snapshot keeps a filter of the trigrams of its lines, which is
+   rebuilt only after the page text changed; pages that can't contain the
+   text aren't scanned. Pages which can't be fetched while another page is
+   selected (see \ref prefetch_page_check) are searched only if selected.
+
+   \param[in]  ctx    Context
+   \param[in]  text   Text to search (case sensitive)
+   \param[out] result Matches, in page and line order
+   \param[in]  max    Size of result
+
+   \return Number of matches (up to max); -1 on error
+*/
+int top_search(struct top_context *ctx, const char *text,
+	       struct top_search_result *result, unsigned int max);
+
+/** Get number of pages scanned line by line by the last search */
+unsigned int top_search_scanned_get(struct top_context *ctx);
+
+/** Release search indexes */
+void search_shutdown(struct top_context *ctx);
+
+#endif
@@ -0,0 +1,450 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_server.h"
+
+#include <stdarg.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/*
+   Protocol (one request or reply line per '\n'):
+
+   client: GET <epoch> <seq> <page name>
+   server: PAGE <epoch> <seq> <total> <count>
+           followed by <count> lines "<line number> <text>", where line
+           number -1 is the header
+
+   Only lines changed after <seq> are sent; if the epoch doesn't match
+   (server restart) all lines are sent. Lines beyond <total> are dropped.
+*/
+
+/** Line change tracking of a cached page */
+struct server_page {
+	/** Hash of each line; entry 0 is the header */
+	uint64_t *hash;
+	/** Sequence number of the last change of each line */
+	uint32_t *seq;
+	/** Size of hash and seq */
+	unsigned int size;
+	/** Number of lines of the previous snapshot */
+	int total;
+	/** Snapshot generation the hashes belong to; 0 if none */
+	uint32_t gen;
+};
+
+/** Connected client */
+struct server_client {
+	int fd;
+	/** Incomplete request */
+	char in[TOP_LINE_LEN];
+	size_t in_len;
+	/** Pending reply */
+	char *out;
+	size_t out_len;
+	size_t out_off;
+	size_t out_size;
+};
+
+struct top_server {
+	struct top_context *ctx;
+	/** Listening socket */
+	int fd;
+	/** Identifies this server instance */
+	uint32_t epoch;
+	/** Sequence number of the last fetch */
+	uint32_t seq;
+	struct server_page *page;
+	struct server_client client[TOP_SERVER_CLIENT_MAX];
+	unsigned int client_num;
+};
+
+/** Fetch page if its snapshot is older than the update delay and update
+   line change tracking
+
+   \return Snapshot; NULL if the page can't be fetched
+*/
+static const struct top_snapshot *page_update(struct top_server *srv,
+					      unsigned int page_idx)
+{
+	struct top_context *ctx = srv->ctx;
+	struct server_page *p = &srv->page[page_idx];
+	const struct top_snapshot *snap;
+	const char *line;
+	uint64_t hash;
+	int i;
+
+	snap = snapshot_cache_get(ctx, page_idx,
+				  top_page_interval_get(ctx, page_idx));
+	if (!snap || snap->gen == p->gen)
+		return snap;
+
+	if (p->size < (unsigned int)snap->total + 1) {
+		unsigned int size = snap->total + 1;
+		uint64_t *h = realloc(p->hash, sizeof(*h) * size);
+		uint32_t *s;
+
+		if (!h)
+			return NULL;
+		p->hash = h;
+
+		s = realloc(p->seq, sizeof(*s) * size);
+		if (!s)
+			return NULL;
+		p->seq = s;
+
+		/* new entries are marked as changed below */
+		p->size = size;
+	}
+
+	srv->seq++;
+
+	for (i = -1; i < snap->total; i++) {
+		line = top_snapshot_line_get(snap, i);
+		hash = top_hash(line, strlen(line));
+
+		if (!p->gen || i >= p->total ||
+		    hash != p->hash[i + 1]) {
+			p->hash[i + 1] = hash;
+			p->seq[i + 1] = srv->seq;
+		}
+	}
+
+	p->total = snap->total;
+	p->gen = snap->gen;
+
+	return snap;
+}
+
+/** Append formatted text to the pending reply
+
+   \return 0 on success; -1 if out of memory
+*/
+static int client_printf(struct server_client *cl, const char *fmt, ...)
+{
+	va_list ap;
+	int len;
+
+	while (1) {
+		size_t avail = cl->out_size - cl->out_len;
+
+		va_start(ap, fmt);
+		len = vsnprintf(cl->out + cl->out_len, avail, fmt, ap);
+		va_end(ap);
+
+		if (len < 0)
+			return -1;
+
+		if ((size_t)len < avail) {
+			cl->out_len += len;
+			return 0;
+		} else {
+			size_t size = cl->out_size ? cl->out_size * 2 : 65536;
+			char *out;
+
+			if (size < cl->out_len + len + 1)
+				size = cl->out_len + len + 1;
+
+			out = realloc(cl->out, size);
+			if (!out)
+				return -1;
+
+			cl->out = out;
+			cl->out_size = size;
+		}
+	}
+}
+
+/** Handle "GET" request */
+static int client_get(struct top_server *srv, struct server_client *cl,
+		      const char *req)
+{
+	const struct top_snapshot *snap;
+	struct server_page *p;
+	unsigned int epoch, seq, count = 0;
+	int page_idx, off = 0, i;
+
+	if (sscanf(req, "GET %u %u %n", &epoch, &seq, &off) < 2 || !off)
+		return client_printf(cl, "ERR invalid request\n");
+
+	page_idx = top_page_find(srv->ctx, req + off);
+	if (page_idx < 0)
+		return client_printf(cl, "ERR unknown page\n");
+
+	snap = page_update(srv, page_idx);
+	if (!snap)
+		return client_printf(cl, "ERR fetch failed\n");
+
+	p = &srv->page[page_idx];
+
+	/* unknown state of the client, send everything */
+	if (epoch != srv->epoch || seq > srv->seq)
+		seq = 0;
+
+	for (i = 0; i <= snap->total; i++)
+		if (p->seq[i] > seq)
+			count++;
+
+	if (client_printf(cl, "PAGE %u %u %d %u\n", srv->epoch, srv->seq,
+			  snap->total, count))
+		return -1;
+
+	for (i = 0; i <= snap->total; i++)
+		if (p->seq[i] > seq &&
+		    client_printf(cl, "%d %s\n", i - 1,
+				  top_snapshot_line_get(snap, i - 1)))
+			return -1;
+
+	return 0;
+}
+
+/** Read requests of a client
+
+   \return 0 on success; -1 if the client has to be closed
+*/
+static int client_read(struct top_server *srv, struct server_client *cl)
+{
+	char *nl;
+	ssize_t n;
+
+	n = recv(cl->fd, cl->in + cl->in_len, sizeof(cl->in) - cl->in_len - 1,
+		 0);
+	if (n <= 0)
+		return n < 0 && errno == EINTR ? 0 : -1;
+
+	cl->in_len += n;
+	cl->in[cl->in_len] = 0;
+
+	while ((nl = strchr(cl->in, '\n')) != NULL) {
+		*nl = 0;
+
+		if (strncmp(cl->in, "GET ", 4) == 0) {
+			if (client_get(srv, cl, cl->in))
+				return -1;
+		} else if (client_printf(cl, "ERR unknown request\n")) {
+			return -1;
+		}
+
+		cl->in_len -= nl + 1 - cl->in;
+		memmove(cl->in, nl + 1, cl->in_len + 1);
+	}
+
+	/* request too long */
+	if (cl->in_len == sizeof(cl->in) - 1)
+		return -1;
+
+	return 0;
+}
+
+/** Send pending reply
+
+   \return 0 on success; -1 if the client has to be closed
+*/
+static int client_write(struct server_client *cl)
+{
+	ssize_t n;
+
+	n = send(cl->fd, cl->out + cl->out_off, cl->out_len - cl->out_off,
+		 MSG_NOSIGNAL | MSG_DONTWAIT);
+	if (n < 0)
+		return errno == EINTR || errno == EAGAIN ? 0 : -1;
+
+	cl->out_off += n;
+	if (cl->out_off == cl->out_len) {
+		cl->out_off = 0;
+		cl->out_len = 0;
+	}
+
+	return 0;
+}
+
+static void client_close(struct server_client *cl)
+{
+	close(cl->fd);
+	free(cl->out);
+	memset(cl, 0, sizeof(*cl));
+	cl->fd = -1;
+}
+
+static void server_accept(struct top_server *srv)
+{
+	struct server_client *cl;
+	int fd;
+
+	fd = accept(srv->fd, NULL, NULL);
+	if (fd < 0)
+		return;
+
+	if (srv->client_num == TOP_SERVER_CLIENT_MAX) {
+		close(fd);
+		return;
+	}
+
+	cl = &srv->client[srv->client_num++];
+	memset(cl, 0, sizeof(*cl));
+	cl->fd = fd;
+}
+
+static void server_free(struct top_server *srv)
+{
+	unsigned int i;
+
+	for (i = 0; i < srv->client_num; i++)
+		client_close(&srv->client[i]);
+
+	for (i = 0; srv->page && i < srv->ctx->page_num; i++) {
+		free(srv->page[i].hash);
+		free(srv->page[i].seq);
+	}
+
+	if (srv->fd >= 0)
+		close(srv->fd);
+
+	free(srv->page);
+	free(srv);
+}
+
+/** Remove the socket left behind by a server which is gone
+
+   \return 0 if the path can be bound; -1 if a server listens on it
+*/
+static int socket_stale_remove(const struct sockaddr_un *addr)
+{
+	int fd, ret = 0;
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+
+	/* other errors (e.g. no such file) are left to bind */
+	if (connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) == 0)
+		ret = -1;
+	else if (errno == ECONNREFUSED)
+		unlink(addr->sun_path);
+
+	close(fd);
+
+	return ret;
+}
+
+int top_server_run(struct top_context *ctx, const char *path)
+{
+	struct pollfd pfd[TOP_SERVER_CLIENT_MAX + TOP_METRICS_CONN_MAX + 2];
+	struct sockaddr_un addr;
+	struct top_server *srv;
+	struct timeval tv;
+	unsigned int i, k, num, timeout;
+
+	if (path && strlen(path) >= sizeof(addr.sun_path))
+		return -1;
+
+	if (!path && !ctx->metrics)
+		return -1;
+
+	srv = malloc(sizeof(*srv));
+	if (!srv)
+		return -1;
+
+	memset(srv, 0, sizeof(*srv));
+	srv->ctx = ctx;
+	srv->fd = -1;
+	top_time_get(&tv);
+	srv->epoch = (uint32_t)tv.tv_sec ^ ((uint32_t)getpid() << 16);
+
+	srv->page = calloc(ctx->page_num, sizeof(*srv->page));
+	if (!srv->page) {
+		server_free(srv);
+		return -1;
+	}
+
+	if (path) {
+		srv->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (srv->fd < 0) {
+			server_free(srv);
+			return -1;
+		}
+
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		strcpy(addr.sun_path, path);
+
+		if (socket_stale_remove(&addr) ||
+		    bind(srv->fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+		    listen(srv->fd, TOP_SERVER_CLIENT_MAX)) {
+			server_free(srv);
+			return -1;
+		}
+	}
+
+	while (!ctx->need_shutdown) {
+		timeout = metrics_refresh(ctx);
+		if (timeout > 500)
+			timeout = 500;
+
+		/* poll ignores negative descriptors */
+		pfd[0].fd = srv->fd;
+		pfd[0].events = POLLIN;
+		for (i = 0; i < srv->client_num; i++) {
+			pfd[i + 1].fd = srv->client[i].fd;
+			pfd[i + 1].events = srv->client[i].out_len ?
+							POLLOUT : POLLIN;
+		}
+
+		/* the metrics entries follow the clients */
+		num = srv->client_num + 1;
+		k = num;
+		num += metrics_pollfd_get(ctx, &pfd[num]);
+
+		if (poll(pfd, num, timeout) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		metrics_poll_handle(ctx, &pfd[k]);
+
+		/* pfd entries match the clients until the compaction below */
+		for (i = 0; i < srv->client_num; i++) {
+			struct server_client *cl = &srv->client[i];
+			int err = 0;
+
+			if (pfd[i + 1].revents & POLLOUT)
+				err = client_write(cl);
+			else if (pfd[i + 1].revents & POLLIN)
+				err = client_read(srv, cl);
+			else if (pfd[i + 1].revents & (POLLERR | POLLHUP))
+				err = -1;
+
+			if (err)
+				client_close(cl);
+		}
+
+		for (i = 0, k = 0; i < srv->client_num; i++)
+			if (srv->client[i].fd >= 0)
+				srv->client[k++] = srv->client[i];
+		srv->client_num = k;
+
+		if (pfd[0].revents & POLLIN)
+			server_accept(srv);
+	}
+
+	server_free(srv);
+	if (path)
+		unlink(path);
+
+	return 0;
+}
+
+#endif
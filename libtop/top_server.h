@@ -0,0 +1,67 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_server_h
+#define __top_server_h
+
+/** Default path of the snapshot server socket */
+#define TOP_SERVER_PATH_DEFAULT "/var/run/top.sock"
+
+/** Maximum number of clients served at the same time */
+#define TOP_SERVER_CLIENT_MAX 32
+
+/** Timeout (in ms) of a client waiting for the server reply */
+#define TOP_REMOTE_TIMEOUT 2000
+
+struct top_context;
+
+/** Serve page snapshots over a UNIX domain socket
+
+   Pages are fetched on client request, but at most once per update delay;
+   all other requests are served from the last snapshot. Clients receive
+   only the lines which changed since their previous request of the page.
+
+   If the metrics endpoint is enabled (see top_metrics_init), its pages
+   are fetched once per update delay and its scrapes are answered too.
+
+   The function returns when the main loop is stopped with top_ui_stop.
+   A socket left behind by a server which is gone is replaced; the socket
+   of a running server isn't.
+
+   \param[in] ctx  Context
+   \param[in] path Socket path; NULL to serve only the metrics endpoint
+
+   \return 0 on success; -1 on error
+*/
+int top_server_run(struct top_context *ctx, const char *path);
+
+/** Fetch pages from a snapshot server instead of reading them locally
+
+   Only pages using top_proc_line_get are fetched remotely. If the server
+   goes away, pages are read locally again.
+
+   \param[in] ctx  Context
+   \param[in] path Socket path
+
+   \return 0 on success; -1 if the server can't be reached
+*/
+int top_remote_attach(struct top_context *ctx, const char *path);
+
+/** Stop fetching pages from the snapshot server */
+void top_remote_detach(struct top_context *ctx);
+
+/** Fetch page from the snapshot server into the page buffer
+
+   If the server can't fetch the page itself, the page is empty, as after
+   a failed local read.
+
+   \return Number of lines; -1 if the page can't be fetched remotely
+*/
+int remote_fetch(struct top_context *ctx, unsigned int page_idx);
+
+#endif
@@ -0,0 +1,185 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_shm.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct top_shm {
+	char name[TOP_LINE_LEN];
+	struct top_shm_header *hdr;
+	struct top_shm_page *page;
+	/** Slot is built here and copied under the sequence lock */
+	char *stage;
+};
+
+int top_shm_publish_init(struct top_context *ctx, const char *name,
+			 unsigned int slot_size)
+{
+	struct top_shm *shm;
+	uint64_t size, off;
+	unsigned int i;
+	void *p;
+	int fd;
+
+	/* the header line has to fit into every slot */
+	if (ctx->shm || strlen(name) >= sizeof(shm->name) ||
+	    slot_size < TOP_LINE_LEN + 2 * sizeof(uint32_t))
+		return -1;
+
+	/* keep the slots aligned for the offset tables */
+	slot_size = (slot_size + 7) & ~7u;
+
+	off = sizeof(struct top_shm_header) +
+	      sizeof(struct top_shm_page) * ctx->page_num;
+	off = (off + 7) & ~(uint64_t)7;
+	size = off + (uint64_t)slot_size * ctx->page_num;
+
+	shm = malloc(sizeof(*shm));
+	if (!shm)
+		return -1;
+
+	memset(shm, 0, sizeof(*shm));
+	strcpy(shm->name, name);
+
+	shm->stage = malloc(slot_size);
+	if (!shm->stage) {
+		free(shm);
+		return -1;
+	}
+
+	/* readers of a previous instance keep their old mapping */
+	shm_unlink(name);
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0) {
+		free(shm->stage);
+		free(shm);
+		return -1;
+	}
+
+	if (ftruncate(fd, size)) {
+		close(fd);
+		shm_unlink(name);
+		free(shm->stage);
+		free(shm);
+		return -1;
+	}
+
+	p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED) {
+		shm_unlink(name);
+		free(shm->stage);
+		free(shm);
+		return -1;
+	}
+
+	shm->hdr = p;
+	shm->page = (struct top_shm_page *)(shm->hdr + 1);
+
+	for (i = 0; i < ctx->page_num; i++) {
+		snprintf(shm->page[i].name, TOP_SHM_PAGE_NAME_LEN, "%s",
+			 ctx->page[i].name);
+		shm->page[i].off = off + (uint64_t)slot_size * i;
+	}
+
+	shm->hdr->page_num = ctx->page_num;
+	shm->hdr->slot_size = slot_size;
+	shm->hdr->size = size;
+	shm->hdr->version = TOP_SHM_VERSION;
+	/* readers check the magic last */
+	__atomic_store_n(&shm->hdr->magic, TOP_SHM_MAGIC, __ATOMIC_RELEASE);
+
+	ctx->shm = shm;
+
+	return 0;
+}
+
+void top_shm_publish_shutdown(struct top_context *ctx)
+{
+	struct top_shm *shm = ctx->shm;
+
+	if (!shm)
+		return;
+
+	munmap(shm->hdr, shm->hdr->size);
+	shm_unlink(shm->name);
+	free(shm->stage);
+	free(shm);
+	ctx->shm = NULL;
+}
+
+void shm_publish(struct top_context *ctx, unsigned int page_idx)
+{
+	struct top_shm *shm = ctx->shm;
+	struct top_shm_page *page = &shm->page[page_idx];
+	uint32_t slot_size = shm->hdr->slot_size;
+	int total = ctx->page_state[page_idx].total;
+	char buff[TOP_LINE_LEN];
+	struct timeval tv;
+	uint32_t off, len, seq;
+	bool truncated = false;
+	char *p;
+	int i;
+
+	if (!ctx->page[page_idx].line_get || total < 0)
+		return;
+
+	/* the offset table, the header and the last NUL have to fit */
+	if ((uint64_t)(total + 1) * sizeof(off) + TOP_LINE_LEN + 1 >
+	    slot_size) {
+		total = (slot_size - TOP_LINE_LEN - 1) / sizeof(off) - 1;
+		truncated = true;
+	}
+
+	off = (total + 1) * sizeof(off);
+
+	for (i = -1; i < total; i++) {
+		buff[0] = 0;
+		p = ctx->page[page_idx].line_get(ctx, i, buff);
+		if (p == NULL)
+			p = buff;
+
+		len = strlen(p) + 1;
+		if (off + len > slot_size - 1) {
+			/* the header always fits, see top_shm_publish_init */
+			total = i;
+			truncated = true;
+			break;
+		}
+
+		memcpy(shm->stage + (i + 1) * sizeof(off), &off, sizeof(off));
+		memcpy(shm->stage + off, p, len);
+		off += len;
+	}
+
+	top_time_get(&tv);
+
+	seq = page->seq;
+	__atomic_store_n(&page->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	memcpy((char *)shm->hdr + page->off, shm->stage, off);
+	((char *)shm->hdr)[page->off + slot_size - 1] = 0;
+	page->total = total;
+	page->truncated = truncated;
+	page->sec = tv.tv_sec;
+	page->usec = tv.tv_usec;
+
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&page->seq, seq + 2, __ATOMIC_RELAXED);
+}
+
+#endif
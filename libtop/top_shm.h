@@ -0,0 +1,159 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_shm_h
+#define __top_shm_h
+
+/*
+   Shared memory layout:
+
+   struct top_shm_header
+   struct top_shm_page[page_num]
+   page slots; each slot holds the offsets (relative to the slot) of the
+   header and of the lines, followed by the NUL terminated texts. The last
+   byte of a slot is always 0.
+
+   Each page is protected by a sequence lock: the publisher makes seq odd
+   while it updates the slot, readers retry if seq was odd or changed while
+   they were reading. A seq of 0 means the page wasn't published yet.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Layout identifier ("TOPS") */
+#define TOP_SHM_MAGIC 0x53504f54
+
+/** Layout version */
+#define TOP_SHM_VERSION 1
+
+/** Default name of the shared memory object */
+#define TOP_SHM_NAME_DEFAULT "/top"
+
+/** Default size of a page slot */
+#define TOP_SHM_SLOT_SIZE_DEFAULT 65536
+
+/** Maximum length (including NUL) of a page name */
+#define TOP_SHM_PAGE_NAME_LEN 32
+
+struct top_context;
+
+/** Region header */
+struct top_shm_header {
+	uint32_t magic;
+	uint32_t version;
+	/** Number of pages */
+	uint32_t page_num;
+	/** Size of each page slot */
+	uint32_t slot_size;
+	/** Size of the whole region */
+	uint64_t size;
+};
+
+/** Page descriptor */
+struct top_shm_page {
+	/** Sequence lock; odd while the slot is updated */
+	uint32_t seq;
+	/** Number of lines (without header) */
+	uint32_t total;
+	/** Page didn't fit into the slot */
+	uint32_t truncated;
+	/** Publication time */
+	int32_t usec;
+	int64_t sec;
+	/** Offset of the slot from the region start */
+	uint64_t off;
+	char name[TOP_SHM_PAGE_NAME_LEN];
+};
+
+/** Publish every fetched page into a shared memory object
+
+   Only the calling process writes the object; it is removed again by
+   \ref top_shm_publish_shutdown.
+
+   \param[in] ctx       Context
+   \param[in] name      Name of the shared memory object (see shm_open)
+   \param[in] slot_size Bytes reserved for each page
+
+   \return 0 on success; -1 on error
+*/
+int top_shm_publish_init(struct top_context *ctx, const char *name,
+			 unsigned int slot_size);
+
+/** Stop publishing and remove the shared memory object */
+void top_shm_publish_shutdown(struct top_context *ctx);
+
+/** Publish fetched page */
+void shm_publish(struct top_context *ctx, unsigned int page_idx);
+
+/** Mapping of a published region (reader side, see libtopshm) */
+struct top_shm_map {
+	const struct top_shm_header *hdr;
+	const struct top_shm_page *page;
+	/** Size of the mapping */
+	uint64_t size;
+};
+
+/** Map published region read-only
+
+   \param[out] map  Mapping
+   \param[in]  name Name of the shared memory object
+
+   \return 0 on success; -1 if the object doesn't exist or has an
+           unknown layout
+*/
+int top_shm_open(struct top_shm_map *map, const char *name);
+
+/** Unmap region */
+void top_shm_close(struct top_shm_map *map);
+
+/** Find page by name
+
+   \return Page index; -1 if not found
+*/
+int top_shm_page_find(const struct top_shm_map *map, const char *name);
+
+/** Start reading a page
+
+   Typical usage:
+
+   do {
+	seq = top_shm_read_begin(map, page);
+	... top_shm_total() / top_shm_line_get() ...
+   } while (top_shm_read_retry(map, page, seq));
+
+   \return Sequence to pass to top_shm_read_retry; 0 if the page wasn't
+           published yet
+*/
+uint32_t top_shm_read_begin(const struct top_shm_map *map, unsigned int page);
+
+/** Check whether the page changed while it was read
+
+   \return true if the data read since top_shm_read_begin is inconsistent
+*/
+bool top_shm_read_retry(const struct top_shm_map *map, unsigned int page,
+			uint32_t seq);
+
+/** Get number of lines (without header) of a page */
+int top_shm_total(const struct top_shm_map *map, unsigned int page);
+
+/** Get line of a page
+
+   The text points into the mapping and may change under the reader;
+   use it only between top_shm_read_begin and top_shm_read_retry.
+
+   \param[in] map  Mapping
+   \param[in] page Page index
+   \param[in] line Line number; -1 for header
+
+   \return Line text; NULL if the line doesn't exist
+*/
+const char *top_shm_line_get(const struct top_shm_map *map, unsigned int page,
+			     int line);
+
+#endif
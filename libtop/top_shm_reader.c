@@ -0,0 +1,125 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top_shm.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+int top_shm_open(struct top_shm_map *map, const char *name)
+{
+	const struct top_shm_header *hdr;
+	struct stat st;
+	void *p;
+	int fd;
+
+	fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0)
+		return -1;
+
+	if (fstat(fd, &st) || (size_t)st.st_size < sizeof(*hdr)) {
+		close(fd);
+		return -1;
+	}
+
+	p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+		return -1;
+
+	hdr = p;
+	if (hdr->magic != TOP_SHM_MAGIC || hdr->version != TOP_SHM_VERSION ||
+	    hdr->size != (uint64_t)st.st_size) {
+		munmap(p, st.st_size);
+		return -1;
+	}
+
+	map->hdr = hdr;
+	map->page = (const struct top_shm_page *)(hdr + 1);
+	map->size = st.st_size;
+
+	return 0;
+}
+
+void top_shm_close(struct top_shm_map *map)
+{
+	if (map->hdr)
+		munmap((void *)map->hdr, map->size);
+
+	map->hdr = NULL;
+	map->page = NULL;
+	map->size = 0;
+}
+
+int top_shm_page_find(const struct top_shm_map *map, const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < map->hdr->page_num; i++)
+		if (strncmp(map->page[i].name, name,
+			    TOP_SHM_PAGE_NAME_LEN) == 0)
+			return i;
+
+	return -1;
+}
+
+uint32_t top_shm_read_begin(const struct top_shm_map *map, unsigned int page)
+{
+	uint32_t seq;
+
+	while (1) {
+		seq = __atomic_load_n(&map->page[page].seq, __ATOMIC_ACQUIRE);
+		if (!(seq & 1))
+			return seq;
+
+		/* the publisher holds the page only for a memcpy */
+		sched_yield();
+	}
+}
+
+bool top_shm_read_retry(const struct top_shm_map *map, unsigned int page,
+			uint32_t seq)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return __atomic_load_n(&map->page[page].seq, __ATOMIC_RELAXED) != seq;
+}
+
+int top_shm_total(const struct top_shm_map *map, unsigned int page)
+{
+	return (int)map->page[page].total;
+}
+
+const char *top_shm_line_get(const struct top_shm_map *map, unsigned int page,
+			     int line)
+{
+	const char *slot = (const char *)map->hdr + map->page[page].off;
+	uint32_t slot_size = map->hdr->slot_size;
+	uint32_t total = map->page[page].total;
+	uint32_t off;
+
+	if (line < -1 || line >= (int)total ||
+	    (uint64_t)(line + 2) * sizeof(off) > slot_size)
+		return NULL;
+
+	/* the values may be torn; keep every access inside the slot */
+	memcpy(&off, slot + (line + 1) * sizeof(off), sizeof(off));
+	if (off >= slot_size)
+		return NULL;
+
+	return slot + off;
+}
+
+#endif
@@ -0,0 +1,132 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_signal.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+/* Signals are process-wide, so this is the only state shared between
+   contexts. The handlers only read the slots; attach and detach are
+   serialized by the lock. */
+
+/** Contexts receiving signals */
+static struct top_context *sig_ctx[TOP_SIGNAL_CTX_MAX];
+/** Number of attached contexts */
+static unsigned int sig_ctx_num;
+static pthread_mutex_t sig_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Handled signals */
+static const int sig_num[] = {
+	SIGINT,
+	SIGSEGV,
+#ifdef SIGWINCH
+	SIGWINCH,
+#endif
+};
+
+/** Handlers installed before the first attach */
+static struct sigaction sig_orig[sizeof(sig_num) / sizeof(sig_num[0])];
+
+static void sig_dispatch(int sig)
+{
+	static const char msg[] = "Segmentation fault\n";
+	struct top_context *ctx;
+	unsigned int i;
+	ssize_t ret;
+
+	if (sig == SIGSEGV) {
+		ret = write(STDERR_FILENO, msg, sizeof(msg) - 1);
+		(void)ret;
+	}
+
+	for (i = 0; i < TOP_SIGNAL_CTX_MAX; i++) {
+		ctx = __atomic_load_n(&sig_ctx[i], __ATOMIC_ACQUIRE);
+		if (!ctx)
+			continue;
+
+#ifdef SIGWINCH
+		if (sig == SIGWINCH) {
+			ctx->need_resize = 1;
+			continue;
+		}
+#endif
+		ctx->need_shutdown = 1;
+	}
+}
+
+int top_signal_attach(struct top_context *ctx)
+{
+	struct sigaction sa;
+	unsigned int i;
+	int ret = -1;
+
+	pthread_mutex_lock(&sig_lock);
+
+	for (i = 0; i < TOP_SIGNAL_CTX_MAX; i++) {
+		if (sig_ctx[i] == ctx) {
+			ret = 0;
+			goto out;
+		}
+	}
+
+	for (i = 0; i < TOP_SIGNAL_CTX_MAX; i++)
+		if (!sig_ctx[i])
+			break;
+
+	if (i == TOP_SIGNAL_CTX_MAX)
+		goto out;
+
+	__atomic_store_n(&sig_ctx[i], ctx, __ATOMIC_RELEASE);
+
+	if (sig_ctx_num++ == 0) {
+		memset(&sa, 0, sizeof(sa));
+		sa.sa_handler = sig_dispatch;
+		sa.sa_flags = SA_RESTART;
+		sigemptyset(&sa.sa_mask);
+
+		for (i = 0; i < sizeof(sig_num) / sizeof(sig_num[0]); i++)
+			sigaction(sig_num[i], &sa, &sig_orig[i]);
+	}
+
+	ret = 0;
+
+out:
+	pthread_mutex_unlock(&sig_lock);
+
+	return ret;
+}
+
+void top_signal_detach(struct top_context *ctx)
+{
+	unsigned int i;
+
+	pthread_mutex_lock(&sig_lock);
+
+	for (i = 0; i < TOP_SIGNAL_CTX_MAX; i++) {
+		if (sig_ctx[i] != ctx)
+			continue;
+
+		__atomic_store_n(&sig_ctx[i], NULL, __ATOMIC_RELEASE);
+
+		if (--sig_ctx_num == 0)
+			for (i = 0; i < sizeof(sig_num) / sizeof(sig_num[0]);
+			     i++)
+				sigaction(sig_num[i], &sig_orig[i], NULL);
+		break;
+	}
+
+	pthread_mutex_unlock(&sig_lock);
+}
+
+#endif
@@ -0,0 +1,34 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_signal_h
+#define __top_signal_h
+
+/** Maximum number of contexts receiving signals at the same time */
+#define TOP_SIGNAL_CTX_MAX 32
+
+struct top_context;
+
+/** Deliver process signals to a context
+
+   SIGINT (and SIGSEGV) request the shutdown of the main loop, SIGWINCH
+   makes the context query the terminal size again. Signals are delivered
+   to every attached context. The handlers are installed with the first
+   attached context and the previous ones are restored when the last
+   context is detached.
+
+   \param[in] ctx Context
+
+   \return 0 on success; -1 if too many contexts are attached
+*/
+int top_signal_attach(struct top_context *ctx);
+
+/** Stop delivering process signals to a context */
+void top_signal_detach(struct top_context *ctx);
+
+#endif
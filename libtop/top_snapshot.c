@@ -0,0 +1,305 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_table.h"
+#include "top_snapshot.h"
+
+int top_snapshot_init(struct top_snapshot *snap, size_t size,
+		      unsigned int line_max, bool fixed)
+{
+	memset(snap, 0, sizeof(*snap));
+
+	snap->data = malloc(size);
+	snap->line = malloc(sizeof(*snap->line) * line_max);
+	if (!snap->data || !snap->line) {
+		top_snapshot_free(snap);
+		return -1;
+	}
+
+	snap->size = size;
+	snap->line_max = line_max;
+	snap->fixed = fixed;
+
+	return 0;
+}
+
+void top_snapshot_free(struct top_snapshot *snap)
+{
+	free(snap->data);
+	free(snap->line);
+	snap->data = NULL;
+	snap->line = NULL;
+	snap->size = 0;
+	snap->line_max = 0;
+	snap->len = 0;
+	snap->total = 0;
+}
+
+/** Append line to the snapshot
+
+   \param[in] snap Snapshot
+   \param[in] idx  Line index (0 for header)
+   \param[in] text Line text
+
+   \return 0 on success; -1 if the line doesn't fit
+*/
+static int snapshot_append(struct top_snapshot *snap, unsigned int idx,
+			   const char *text)
+{
+	size_t len = strlen(text) + 1;
+
+	if (idx >= snap->line_max) {
+		unsigned int line_max = snap->line_max ? snap->line_max * 2 : 64;
+		unsigned int *line;
+
+		if (snap->fixed)
+			return -1;
+
+		line = realloc(snap->line, sizeof(*line) * line_max);
+		if (!line)
+			return -1;
+
+		snap->line = line;
+		snap->line_max = line_max;
+	}
+
+	if (snap->len + len > snap->size) {
+		size_t size = snap->size ? snap->size * 2 : 4096;
+		char *data;
+
+		if (snap->fixed)
+			return -1;
+
+		if (size < snap->len + len)
+			size = snap->len + len;
+
+		data = realloc(snap->data, size);
+		if (!data)
+			return -1;
+
+		snap->data = data;
+		snap->size = size;
+	}
+
+	memcpy(snap->data + snap->len, text, len);
+	snap->line[idx] = snap->len;
+	snap->len += len;
+
+	return 0;
+}
+
+int top_snapshot_capture(struct top_context *ctx, unsigned int page_idx,
+			 struct top_snapshot *snap)
+{
+	const struct top_page_desc *page = &ctx->page[page_idx];
+	char buff[TOP_LINE_LEN];
+	char *p;
+	int i;
+
+	snap->page_idx = page_idx;
+	snap->total = 0;
+	snap->len = 0;
+	snap->truncated = false;
+	snap->gen++;
+	top_time_get(&snap->time);
+	snap->stamp = top_time_ms();
+
+	if (!page->line_get)
+		return -1;
+
+	buff[0] = 0;
+	p = page->line_get(ctx, -1, buff);
+	if (p == NULL)
+		p = buff;
+	if (snapshot_append(snap, 0, p)) {
+		snap->truncated = true;
+		return -1;
+	}
+
+	for (i = 0; i < ctx->page_state[page_idx].total; i++) {
+		buff[0] = 0;
+		p = page->line_get(ctx, i, buff);
+		if (p == NULL)
+			p = buff;
+		if (snapshot_append(snap, i + 1, p)) {
+			snap->truncated = true;
+			break;
+		}
+		snap->total++;
+	}
+
+	return snap->total;
+}
+
+const char *top_snapshot_line_get(const struct top_snapshot *snap, int line)
+{
+	if (line < -1 || line >= snap->total || !snap->data)
+		return NULL;
+
+	return snap->data + snap->line[line + 1];
+}
+
+/** Locate table header of the snapshot
+
+   \param[in]  snap  Snapshot
+   \param[out] sep   Column separator
+   \param[out] first First data line
+
+   \return Header line
+*/
+static const char *snapshot_header(const struct top_snapshot *snap,
+				   char *sep, int *first)
+{
+	const char *header = top_snapshot_line_get(snap, -1);
+
+	*first = 0;
+
+	if (!header || !header[0]) {
+		header = top_snapshot_line_get(snap, 0);
+		if (!header)
+			header = "";
+
+		*sep = top_columns_sep(header);
+		if (!top_line_is_data(header, *sep))
+			*first = 1;
+	} else {
+		*sep = top_columns_sep(header);
+	}
+
+	return header;
+}
+
+int top_snapshot_value_get(const struct top_snapshot *snap, const char *row,
+			   const char *column, double *value)
+{
+	char buff[TOP_LINE_LEN];
+	char *col[TOP_COLUMN_MAX];
+	const char *header;
+	int first, idx, n, i;
+	char sep;
+
+	header = snapshot_header(snap, &sep, &first);
+
+	idx = top_column_find(header, sep, column);
+	if (idx < 0)
+		return -1;
+
+	for (i = first; i < snap->total; i++) {
+		n = top_columns_split(top_snapshot_line_get(snap, i), sep,
+				      buff, col, TOP_COLUMN_MAX);
+		if (n > idx && strcmp(col[0], row) == 0)
+			return top_cell_num(col[idx], value);
+	}
+
+	return -1;
+}
+
+const char *snapshot_table_line_get(void *arg, int line, char *buff)
+{
+	return top_snapshot_line_get(arg, line);
+}
+
+int snapshot_cache_update(struct top_context *ctx, unsigned int page_idx)
+{
+	struct top_snapshot *snap;
+
+	if (!ctx->cache) {
+		ctx->cache = calloc(ctx->page_num, sizeof(*ctx->cache));
+		if (!ctx->cache)
+			return -1;
+	}
+
+	snap = &ctx->cache[page_idx];
+
+	/* older data shown after a timeout keeps the time it was fetched */
+	if (ctx->page_state[page_idx].stale)
+		return snap->gen ? 0 : -1;
+
+	/* unchanged text: keep the generation so nothing is rendered again */
+	if (snap->gen && ctx->fetch_hash && snap->hash == ctx->fetch_hash) {
+		top_time_get(&snap->time);
+		snap->stamp = top_time_ms();
+		return 0;
+	}
+
+	if (top_snapshot_capture(ctx, page_idx, snap) < 0)
+		return -1;
+
+	snap->hash = ctx->fetch_hash;
+
+	return 0;
+}
+
+const struct top_snapshot *snapshot_cache_peek(struct top_context *ctx,
+					       unsigned int page_idx)
+{
+	if (!ctx->cache || !ctx->cache[page_idx].gen)
+		return NULL;
+
+	return &ctx->cache[page_idx];
+}
+
+const struct top_snapshot *snapshot_cache_get(struct top_context *ctx,
+					      unsigned int page_idx,
+					      unsigned int max_age)
+{
+	const struct top_snapshot *snap = snapshot_cache_peek(ctx, page_idx);
+
+	if (snap && top_time_ms() - snap->stamp < max_age)
+		return snap;
+
+#ifdef LINUX
+	/* notifying sources are fetched only after a change */
+	if (snap && source_notifies(ctx, page_idx) &&
+	    !source_changed(ctx, page_idx))
+		return snap;
+#endif
+
+	if (counters_fetch(ctx, page_idx) < 0 ||
+	    snapshot_cache_update(ctx, page_idx))
+		return NULL;
+
+	return &ctx->cache[page_idx];
+}
+
+void snapshot_cache_free(struct top_context *ctx)
+{
+	unsigned int i;
+
+	if (!ctx->cache)
+		return;
+
+	for (i = 0; i < ctx->page_num; i++)
+		top_snapshot_free(&ctx->cache[i]);
+
+	free(ctx->cache);
+	ctx->cache = NULL;
+}
+
+void top_snapshot_write(struct top_context *ctx, FILE *f,
+			const struct top_snapshot *snap)
+{
+	const char *header = top_snapshot_line_get(snap, -1);
+	int i;
+
+	fprintf(f, "Page: %s" TOP_CRLF, ctx->page[snap->page_idx].name);
+	fprintf(f, "Time: %lld.%06ld" TOP_CRLF,
+		(long long)snap->time.tv_sec, (long)snap->time.tv_usec);
+
+	if (header && header[0])
+		fprintf(f, "%s" TOP_CRLF, header);
+
+	for (i = 0; i < snap->total; i++)
+		fprintf(f, "%s" TOP_CRLF, top_snapshot_line_get(snap, i));
+
+	if (snap->truncated)
+		fprintf(f, "... more data available" TOP_CRLF);
+}
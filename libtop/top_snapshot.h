@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_snapshot_h
+#define __top_snapshot_h
+
+#include <sys/time.h>
+
+struct top_context;
+
+/** Copy of the page contents taken right after a fetch */
+struct top_snapshot {
+	/** Index of the captured page */
+	unsigned int page_idx;
+	/** Capture time */
+	struct timeval time;
+	/** Capture time (monotonic, in ms) */
+	uint64_t stamp;
+	/** Number of captures into this snapshot */
+	uint32_t gen;
+	/** Hash of the captured page text; 0 if unknown */
+	uint64_t hash;
+	/** Number of lines (without header) */
+	int total;
+	/** Line texts, NUL terminated, header first */
+	char *data;
+	/** Used bytes of data */
+	size_t len;
+	/** Size of data */
+	size_t size;
+	/** Offsets of the lines in data; entry 0 is the header */
+	unsigned int *line;
+	/** Number of entries in line */
+	unsigned int line_max;
+	/** Buffers are preallocated and never grown */
+	bool fixed;
+	/** Last capture didn't fit into the fixed buffers */
+	bool truncated;
+};
+
+/** Initialize snapshot and preallocate its buffers
+
+   \param[in] snap     Snapshot
+   \param[in] size     Size of the text buffer
+   \param[in] line_max Maximum number of lines (including header)
+   \param[in] fixed    Never grow the buffers; truncate the capture instead
+
+   \return 0 on success; -1 if out of memory
+*/
+int top_snapshot_init(struct top_snapshot *snap, size_t size,
+		      unsigned int line_max, bool fixed);
+
+/** Release snapshot buffers */
+void top_snapshot_free(struct top_snapshot *snap);
+
+/** Capture currently fetched data of a page into the snapshot
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page which was fetched last
+   \param[in] snap     Snapshot
+
+   \return Number of captured lines; -1 on error
+*/
+int top_snapshot_capture(struct top_context *ctx, unsigned int page_idx,
+			 struct top_snapshot *snap);
+
+/** Get line from the snapshot
+
+   \param[in] snap Snapshot
+   \param[in] line Line number; -1 for header
+
+   \return Line text; NULL if line doesn't exist
+*/
+const char *top_snapshot_line_get(const struct top_snapshot *snap, int line);
+
+/** Get numeric value of a table cell
+
+   The table header is the page header or, if it is empty, the first line
+   of the page. Rows are identified by the text of their first column.
+
+   \param[in]  snap   Snapshot
+   \param[in]  row    Row key
+   \param[in]  column Column name or "#<n>"
+   \param[out] value  Cell value
+
+   \return 0 on success; -1 if the cell doesn't exist or is not numeric
+*/
+int top_snapshot_value_get(const struct top_snapshot *snap, const char *row,
+			   const char *column, double *value);
+
+/** Get line of a snapshot as table source (see top_table_line_t) */
+const char *snapshot_table_line_get(void *arg, int line, char *buff);
+
+/** Get the latest snapshot of a page, fetching the page if needed
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page
+   \param[in] max_age  Maximum age (in ms) of the cached snapshot
+
+   \return Snapshot; NULL if the page can't be fetched
+*/
+const struct top_snapshot *snapshot_cache_get(struct top_context *ctx,
+					      unsigned int page_idx,
+					      unsigned int max_age);
+
+/** Get the latest snapshot of a page without fetching it
+
+   \return Snapshot; NULL if the page wasn't captured yet
+*/
+const struct top_snapshot *snapshot_cache_peek(struct top_context *ctx,
+					       unsigned int page_idx);
+
+/** Capture fetched page into the snapshot cache
+
+   A page showing older data after a timeout keeps its cached snapshot.
+
+   \return 0 on success; -1 on error or if a page showing older data
+           wasn't cached before
+*/
+int snapshot_cache_update(struct top_context *ctx, unsigned int page_idx);
+
+/** Release snapshot cache */
+void snapshot_cache_free(struct top_context *ctx);
+
+/** Write snapshot to file in the layout used for table dumps
+
+   \param[in] ctx  Context
+   \param[in] f    File to write in
+   \param[in] snap Snapshot
+*/
+void top_snapshot_write(struct top_context *ctx, FILE *f,
+			const struct top_snapshot *snap);
+
+#endif
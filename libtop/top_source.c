@@ -0,0 +1,138 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+/** Read notifying source; the file stays open for the change polling */
+static int notify_read(struct top_context *ctx, struct top_page_state *state,
+		       const char *path)
+{
+	if (state->source_fd < 0) {
+		state->source_fd = open(path, O_RDONLY);
+		ctx->prof.syscalls++;
+		if (state->source_fd < 0)
+			return linux_text_parse(ctx, 0);
+	} else {
+		/* reading from the start again clears the notification */
+		ctx->prof.syscalls++;
+		if (lseek(state->source_fd, 0, SEEK_SET) < 0) {
+			close(state->source_fd);
+			state->source_fd = -1;
+			return linux_text_parse(ctx, 0);
+		}
+	}
+
+	return linux_text_parse(ctx, linux_fd_read(ctx, state->source_fd));
+}
+
+static int ioctl_read(struct top_context *ctx, const struct top_source *src)
+{
+	char arg[TOP_SOURCE_ARG_MAX];
+	size_t s;
+
+	if (!src->format || src->arg_size > sizeof(arg))
+		return linux_text_parse(ctx, 0);
+
+	memset(arg, 0, src->arg_size);
+
+	ctx->prof.syscalls++;
+	if (ioctl(ctx->fd, src->request, arg) < 0)
+		return linux_text_parse(ctx, 0);
+
+	s = src->format(ctx, arg, &ctx->shared_buff[0][0],
+			sizeof(ctx->shared_buff));
+	if (s > sizeof(ctx->shared_buff))
+		s = sizeof(ctx->shared_buff);
+
+	return linux_text_parse(ctx, s);
+}
+
+int source_path(struct top_context *ctx, const struct top_source *src,
+		char *path, size_t size)
+{
+	switch (src->type) {
+	case TOP_SOURCE_PROC:
+		snprintf(path, size, "%s/%s", ctx->proc_root, src->path);
+		return 0;
+
+	case TOP_SOURCE_DEBUGFS:
+		snprintf(path, size, "%s/%s", TOP_DEBUGFS_ROOT, src->path);
+		return 0;
+
+	case TOP_SOURCE_SYSFS:
+		snprintf(path, size, "%s/%s", TOP_SYSFS_ROOT, src->path);
+		return 0;
+
+	case TOP_SOURCE_IOCTL:
+		break;
+	}
+
+	return -1;
+}
+
+int source_fetch(struct top_context *ctx, unsigned int page_idx)
+{
+	const struct top_source *src = ctx->page[page_idx].source;
+	char path[TOP_PROC_ROOT_LEN + TOP_LINE_LEN];
+
+	if (source_path(ctx, src, path, sizeof(path)))
+		return ioctl_read(ctx, src);
+
+	if (src->type == TOP_SOURCE_SYSFS && src->notify)
+		return notify_read(ctx, &ctx->page_state[page_idx], path);
+
+	return linux_file_read(ctx, path);
+}
+
+bool source_notifies(struct top_context *ctx, unsigned int page_idx)
+{
+	return ctx->page[page_idx].source &&
+	       ctx->page[page_idx].source->notify &&
+	       ctx->page_state[page_idx].source_fd >= 0;
+}
+
+bool source_changed(struct top_context *ctx, unsigned int page_idx)
+{
+	struct pollfd pfd;
+
+	if (!source_notifies(ctx, page_idx))
+		return true;
+
+	pfd.fd = ctx->page_state[page_idx].source_fd;
+	pfd.events = POLLPRI;
+	pfd.revents = 0;
+
+	/* fall back to fetching if the source can't be polled */
+	if (poll(&pfd, 1, 0) < 0)
+		return true;
+
+	return pfd.revents != 0;
+}
+
+void source_close(struct top_context *ctx)
+{
+	unsigned int i;
+
+	for (i = 0; i < ctx->page_num; i++) {
+		if (ctx->page_state[i].source_fd < 0)
+			continue;
+
+		close(ctx->page_state[i].source_fd);
+		ctx->page_state[i].source_fd = -1;
+	}
+}
+
+#endif
@@ -0,0 +1,103 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_source_h
+#define __top_source_h
+
+/** Mount point of sysfs */
+#define TOP_SYSFS_ROOT "/sys"
+
+/** Mount point of debugfs */
+#define TOP_DEBUGFS_ROOT "/sys/kernel/debug"
+
+/** Maximum size of an ioctl argument */
+#define TOP_SOURCE_ARG_MAX 4096
+
+/** Interval (in ms) notifying sources are checked for changes */
+#define TOP_SOURCE_CHECK_DELAY 100
+
+struct top_context;
+
+/** Kind of page data source */
+enum top_source_type {
+	/** File below the procfs root (see top_proc_root_set) */
+	TOP_SOURCE_PROC,
+	/** sysfs attribute */
+	TOP_SOURCE_SYSFS,
+	/** debugfs file */
+	TOP_SOURCE_DEBUGFS,
+	/** ioctl on the device FD of the context */
+	TOP_SOURCE_IOCTL
+};
+
+/** Convert ioctl result to page text
+
+   \param[in]  ctx  Context
+   \param[in]  arg  ioctl argument after the call
+   \param[out] text Page text, lines separated by '\n'
+   \param[in]  size Size of text
+
+   \return Length of the text
+*/
+typedef size_t (top_source_format_t) (struct top_context *ctx,
+				      const void *arg, char *text,
+				      size_t size);
+
+/** Page data source */
+struct top_source {
+	enum top_source_type type;
+	/** File path relative to the mount point (file sources) */
+	const char *path;
+	/** Request code (ioctl source) */
+	unsigned long request;
+	/** Argument size, at most TOP_SOURCE_ARG_MAX (ioctl source) */
+	size_t arg_size;
+	/** Argument to text conversion (ioctl source) */
+	top_source_format_t *format;
+	/** Source signals changes with POLLPRI (sysfs_notify); the page is
+	    fetched only after a change instead of every update delay */
+	bool notify;
+};
+
+/** Build path of a file source
+
+   \param[in]  ctx  Context
+   \param[in]  src  Source
+   \param[out] path Path of the file
+   \param[in]  size Size of path
+
+   \return 0 on success; -1 if the source isn't a file
+*/
+int source_path(struct top_context *ctx, const struct top_source *src,
+		char *path, size_t size);
+
+/** Fetch page from its source into the shared buffer
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page with a source
+
+   \return Number of lines; -1 on error
+*/
+int source_fetch(struct top_context *ctx, unsigned int page_idx);
+
+/** Check whether the page is fetched on change notifications
+
+   \return true if the source notifies and is open
+*/
+bool source_notifies(struct top_context *ctx, unsigned int page_idx);
+
+/** Check notifying source for a change (doesn't clear the notification)
+
+   \return true if the page has to be fetched again
+*/
+bool source_changed(struct top_context *ctx, unsigned int page_idx);
+
+/** Close the sources of all pages */
+void source_close(struct top_context *ctx);
+
+#endif
@@ -0,0 +1,467 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_table.h"
+
+#include <math.h>
+
+/** Separators checked in order of preference */
+static const char table_sep[] = { ';', '|', ',', '\t', ':' };
+
+/** Remove leading and trailing white space in place */
+static char *trim(char *s)
+{
+	char *end;
+
+	while (*s && isspace((unsigned char)*s))
+		s++;
+
+	end = s + strlen(s);
+	while (end > s && isspace((unsigned char)end[-1]))
+		*--end = 0;
+
+	return s;
+}
+
+char top_columns_sep(const char *header)
+{
+	unsigned int i;
+
+	if (!header)
+		return TOP_SEP_SPACE;
+
+	for (i = 0; i < ARRAY_SIZE(table_sep); i++)
+		if (strchr(header, table_sep[i]))
+			return table_sep[i];
+
+	return TOP_SEP_SPACE;
+}
+
+int top_columns_split(const char *line, char sep, char *buff,
+		      char **col, int max)
+{
+	char *p = buff;
+	int n = 0;
+
+	snprintf(buff, TOP_LINE_LEN, "%s", line ? line : "");
+
+	if (sep == TOP_SEP_SPACE) {
+		while (n < max) {
+			while (*p && isspace((unsigned char)*p))
+				p++;
+			if (!*p)
+				break;
+
+			col[n++] = p;
+
+			while (*p && !isspace((unsigned char)*p))
+				p++;
+			if (!*p)
+				break;
+			*p++ = 0;
+		}
+
+		return n;
+	}
+
+	while (n < max) {
+		/* "key: value" pages - the value may contain colons */
+		char *end = (sep == ':' && n > 0) ? NULL : strchr(p, sep);
+
+		if (end)
+			*end = 0;
+
+		col[n++] = trim(p);
+
+		if (!end)
+			break;
+		p = end + 1;
+	}
+
+	return n;
+}
+
+int top_column_find(const char *header, char sep, const char *name)
+{
+	char buff[TOP_LINE_LEN];
+	char *col[TOP_COLUMN_MAX];
+	int n, i;
+
+	if (name[0] == '#') {
+		i = atoi(name + 1);
+		return i > 0 ? i - 1 : -1;
+	}
+
+	n = top_columns_split(header, sep, buff, col, TOP_COLUMN_MAX);
+	for (i = 0; i < n; i++)
+		if (strcmp(col[i], name) == 0)
+			return i;
+
+	return -1;
+}
+
+int top_cell_num(const char *cell, double *value)
+{
+	const char *p;
+	char *end;
+
+	while (*cell && isspace((unsigned char)*cell))
+		cell++;
+
+	/* reject "nan", "inf" and alike */
+	p = cell;
+	if (*p == '+' || *p == '-')
+		p++;
+	if (*p == '.')
+		p++;
+	if (!isdigit((unsigned char)*p))
+		return -1;
+
+	if (cell[0] == '0' && (cell[1] == 'x' || cell[1] == 'X')) {
+		*value = (double)strtoull(cell + 2, &end, 16);
+		if (end == cell + 2)
+			return -1;
+	} else {
+		*value = strtod(cell, &end);
+		if (end == cell)
+			return -1;
+	}
+
+	/* allow a unit after the number, e.g. "-20.1 dBm" */
+	if (*end && !isspace((unsigned char)*end))
+		return -1;
+
+	return 0;
+}
+
+bool top_line_is_data(const char *line, char sep)
+{
+	char buff[TOP_LINE_LEN];
+	char *col[TOP_COLUMN_MAX];
+	double value;
+	int n, i;
+
+	n = top_columns_split(line, sep, buff, col, TOP_COLUMN_MAX);
+	for (i = 1; i < n; i++)
+		if (top_cell_num(col[i], &value) == 0)
+			return true;
+
+	return false;
+}
+
+enum top_cell_type top_cell_type_get(const char *cell)
+{
+	double value;
+	const char *p;
+
+	if (!cell[0])
+		return TOP_CELL_NONE;
+
+	if (top_cell_num(cell, &value))
+		return TOP_CELL_STRING;
+
+	if (cell[0] == '0' && (cell[1] == 'x' || cell[1] == 'X'))
+		return TOP_CELL_INT;
+
+	for (p = cell; *p && !isspace((unsigned char)*p); p++)
+		if (*p == '.' || *p == 'e' || *p == 'E')
+			return TOP_CELL_FLOAT;
+
+	return TOP_CELL_INT;
+}
+
+void top_schema_detect(struct top_schema *schema, top_table_line_t *line_get,
+		       void *arg, int total)
+{
+	char lbuff[TOP_LINE_LEN];
+	char cbuff[TOP_LINE_LEN];
+	char *col[TOP_COLUMN_MAX];
+	const char *line;
+	int i, k, n;
+
+	memset(schema, 0, sizeof(*schema));
+
+	lbuff[0] = 0;
+	line = line_get(arg, -1, lbuff);
+	if (line && line[0]) {
+		schema->sep = top_columns_sep(line);
+	} else {
+		line = total > 0 ? line_get(arg, 0, lbuff) : NULL;
+		schema->sep = top_columns_sep(line);
+		if (line && !top_line_is_data(line, schema->sep))
+			schema->first = 1;
+		else
+			line = NULL;
+	}
+
+	if (line) {
+		n = top_columns_split(line, schema->sep, cbuff, col,
+				      TOP_COLUMN_MAX);
+		for (k = 0; k < n; k++)
+			snprintf(schema->name[k], TOP_COLUMN_NAME_LEN, "%s",
+				 col[k]);
+		schema->cols = n;
+	}
+
+	for (i = schema->first; i < total; i++) {
+		lbuff[0] = 0;
+		line = line_get(arg, i, lbuff);
+		if (!line)
+			continue;
+
+		n = top_columns_split(line, schema->sep, cbuff, col,
+				      TOP_COLUMN_MAX);
+		for (k = 0; k < n; k++) {
+			enum top_cell_type type = top_cell_type_get(col[k]);
+
+			if (type > schema->type[k])
+				schema->type[k] = type;
+		}
+
+		if (n > schema->cols)
+			schema->cols = n;
+	}
+
+	for (k = 0; k < schema->cols; k++)
+		if (!schema->name[k][0])
+			snprintf(schema->name[k], TOP_COLUMN_NAME_LEN,
+				 "col%d", k + 1);
+}
+
+/** Page as table source */
+struct page_table {
+	struct top_context *ctx;
+	unsigned int page_idx;
+};
+
+static const char *page_line_get(void *arg, int line, char *buff)
+{
+	struct page_table *t = arg;
+	char *p;
+
+	buff[0] = 0;
+	p = t->ctx->page[t->page_idx].line_get(t->ctx, line, buff);
+	if (p == NULL && buff[0] != 0)
+		p = buff;
+
+	return p;
+}
+
+/** Write JSON string */
+static void json_str_write(top_do_fprintf_t *do_fprintf, FILE *stream,
+			   const char *s)
+{
+	char buff[TOP_LINE_LEN * 6 + 1];
+	char *p = buff;
+
+	for (; *s && p < buff + sizeof(buff) - 7; s++) {
+		unsigned char c = *s;
+
+		if (c == '"' || c == '\\') {
+			*p++ = '\\';
+			*p++ = c;
+		} else if (c < 0x20) {
+			p += sprintf(p, "\\u%04x", c);
+		} else {
+			*p++ = c;
+		}
+	}
+	*p = 0;
+
+	do_fprintf(stream, "\"%s\"", buff);
+}
+
+/** Write CSV field */
+static void csv_str_write(top_do_fprintf_t *do_fprintf, FILE *stream,
+			  const char *s)
+{
+	char buff[TOP_LINE_LEN * 2 + 3];
+	char *p = buff;
+
+	if (!strpbrk(s, ",\"\r\n")) {
+		do_fprintf(stream, "%s", s);
+		return;
+	}
+
+	*p++ = '"';
+	for (; *s && p < buff + sizeof(buff) - 3; s++) {
+		if (*s == '"')
+			*p++ = '"';
+		*p++ = *s;
+	}
+	*p++ = '"';
+	*p = 0;
+
+	do_fprintf(stream, "%s", buff);
+}
+
+/** Write JSON value of a cell */
+static void json_cell_write(top_do_fprintf_t *do_fprintf, FILE *stream,
+			    const char *cell, enum top_cell_type type)
+{
+	double value;
+
+	if (!cell || !cell[0]) {
+		do_fprintf(stream, "null");
+		return;
+	}
+
+	switch (type) {
+	case TOP_CELL_INT:
+		if (cell[0] == '0' && (cell[1] == 'x' || cell[1] == 'X'))
+			do_fprintf(stream, "%llu", strtoull(cell + 2, NULL, 16));
+		else if (cell[0] == '-')
+			do_fprintf(stream, "%lld", strtoll(cell, NULL, 10));
+		else
+			do_fprintf(stream, "%llu", strtoull(cell, NULL, 10));
+		break;
+	case TOP_CELL_FLOAT:
+		/* JSON has no infinity, e.g. of "1e999"; the text is kept */
+		value = strtod(cell, NULL);
+		if (isfinite(value))
+			do_fprintf(stream, "%.15g", value);
+		else
+			json_str_write(do_fprintf, stream, cell);
+		break;
+	default:
+		json_str_write(do_fprintf, stream, cell);
+		break;
+	}
+}
+
+static const char *cell_type_name(enum top_cell_type type)
+{
+	switch (type) {
+	case TOP_CELL_INT:
+		return "integer";
+	case TOP_CELL_FLOAT:
+		return "number";
+	default:
+		return "string";
+	}
+}
+
+/** Write header of the export */
+static void export_begin(struct top_context *ctx, top_do_fprintf_t *do_fprintf,
+			 FILE *stream, const char *page_name,
+			 const struct top_schema *schema)
+{
+	int k;
+
+	switch (ctx->write_format) {
+	case TOP_FORMAT_CSV:
+		do_fprintf(stream, "page");
+		for (k = 0; k < schema->cols; k++) {
+			do_fprintf(stream, ",");
+			csv_str_write(do_fprintf, stream, schema->name[k]);
+		}
+		do_fprintf(stream, TOP_CRLF);
+		break;
+	case TOP_FORMAT_JSON:
+		do_fprintf(stream, "{\"page\":");
+		json_str_write(do_fprintf, stream, page_name);
+		do_fprintf(stream, ",\"columns\":[");
+		for (k = 0; k < schema->cols; k++) {
+			do_fprintf(stream, k ? ",{\"name\":" : "{\"name\":");
+			json_str_write(do_fprintf, stream, schema->name[k]);
+			do_fprintf(stream, ",\"type\":\"%s\"}",
+				   cell_type_name(schema->type[k]));
+		}
+		do_fprintf(stream, "],\"rows\":[");
+		break;
+	default:
+		break;
+	}
+}
+
+/** Write one data line */
+static void export_row(struct top_context *ctx, top_do_fprintf_t *do_fprintf,
+		       FILE *stream, const char *page_name,
+		       const struct top_schema *schema, int row,
+		       char **col, int n)
+{
+	int k;
+
+	switch (ctx->write_format) {
+	case TOP_FORMAT_CSV:
+		csv_str_write(do_fprintf, stream, page_name);
+		for (k = 0; k < schema->cols; k++) {
+			do_fprintf(stream, ",");
+			if (k < n)
+				csv_str_write(do_fprintf, stream, col[k]);
+		}
+		do_fprintf(stream, TOP_CRLF);
+		break;
+	case TOP_FORMAT_NDJSON:
+		do_fprintf(stream, "{\"page\":");
+		json_str_write(do_fprintf, stream, page_name);
+		for (k = 0; k < schema->cols; k++) {
+			do_fprintf(stream, ",");
+			json_str_write(do_fprintf, stream, schema->name[k]);
+			do_fprintf(stream, ":");
+			json_cell_write(do_fprintf, stream,
+					k < n ? col[k] : NULL, schema->type[k]);
+		}
+		do_fprintf(stream, "}" TOP_CRLF);
+		break;
+	case TOP_FORMAT_JSON:
+		do_fprintf(stream, row ? ",[" : "[");
+		for (k = 0; k < schema->cols; k++) {
+			if (k)
+				do_fprintf(stream, ",");
+			json_cell_write(do_fprintf, stream,
+					k < n ? col[k] : NULL, schema->type[k]);
+		}
+		do_fprintf(stream, "]");
+		break;
+	default:
+		break;
+	}
+}
+
+void table_export(struct top_context *ctx, FILE *stream,
+		  unsigned int page_idx)
+{
+	top_do_fprintf_t *do_fprintf = ctx->ops->do_fprintf ?
+						ctx->ops->do_fprintf : fprintf;
+	const char *page_name = ctx->page[page_idx].name;
+	struct page_table table = { ctx, page_idx };
+	struct top_schema schema;
+	char lbuff[TOP_LINE_LEN];
+	char cbuff[TOP_LINE_LEN];
+	char *col[TOP_COLUMN_MAX];
+	const char *line;
+	int i, n, row = 0;
+
+	/* the lines stay in the page buffer, so the types are detected in
+	 * a first pass and nothing has to be kept for the second one */
+	top_schema_detect(&schema, page_line_get, &table,
+			  ctx->page_state[page_idx].total);
+
+	export_begin(ctx, do_fprintf, stream, page_name, &schema);
+
+	for (i = schema.first; i < ctx->page_state[page_idx].total; i++) {
+		line = page_line_get(&table, i, lbuff);
+		if (!line)
+			continue;
+
+		n = top_columns_split(line, schema.sep, cbuff, col,
+				      TOP_COLUMN_MAX);
+		if (!n)
+			continue;
+
+		export_row(ctx, do_fprintf, stream, page_name, &schema, row++,
+			   col, n);
+	}
+
+	if (ctx->write_format == TOP_FORMAT_JSON)
+		do_fprintf(stream, "]}" TOP_CRLF);
+}
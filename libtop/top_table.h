@@ -0,0 +1,138 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_table_h
+#define __top_table_h
+
+/** Maximum number of columns recognized in one table line */
+#define TOP_COLUMN_MAX 64
+
+/** Column separator for tables aligned with white space */
+#define TOP_SEP_SPACE ' '
+
+/** Maximum length of a column name */
+#define TOP_COLUMN_NAME_LEN 64
+
+struct top_context;
+
+/** Cell type */
+enum top_cell_type {
+	/** Not detected yet (no cell seen) */
+	TOP_CELL_NONE,
+	/** Decimal or hex integer */
+	TOP_CELL_INT,
+	/** Floating point number */
+	TOP_CELL_FLOAT,
+	/** Anything else */
+	TOP_CELL_STRING
+};
+
+/** Table layout detected from the header line and the cells */
+struct top_schema {
+	/** Column separator */
+	char sep;
+	/** First data line (1 if the first line is the header) */
+	int first;
+	/** Number of columns */
+	int cols;
+	/** Column names */
+	char name[TOP_COLUMN_MAX][TOP_COLUMN_NAME_LEN];
+	/** Column types */
+	enum top_cell_type type[TOP_COLUMN_MAX];
+};
+
+/** Get line of a table
+
+   \param[in]  arg  Table
+   \param[in]  line Line number; -1 for header
+   \param[out] buff Buffer of TOP_LINE_LEN bytes which may receive the text
+
+   \return Line text; NULL if there is no such line
+*/
+typedef const char *(top_table_line_t)(void *arg, int line, char *buff);
+
+/** Detect column separator of a table
+
+   \param[in] header Header (or first) line of the table
+
+   \return Separator character; TOP_SEP_SPACE for runs of white space
+*/
+char top_columns_sep(const char *header);
+
+/** Split line into columns
+
+   \param[in]  line Line to split (not modified)
+   \param[in]  sep  Separator as returned by \ref top_columns_sep
+   \param[out] buff Buffer of TOP_LINE_LEN bytes receiving the column texts
+   \param[out] col  Pointers to the column texts inside buff
+   \param[in]  max  Size of col
+
+   \return Number of columns
+*/
+int top_columns_split(const char *line, char sep, char *buff,
+		      char **col, int max);
+
+/** Find column index by name
+
+   \param[in] header Header line
+   \param[in] sep    Column separator
+   \param[in] name   Column name or "#<n>" for the n-th (1 based) column
+
+   \return Column index; -1 if not found
+*/
+int top_column_find(const char *header, char sep, const char *name);
+
+/** Parse numeric cell (decimal, floating point or 0x prefixed hex)
+
+   \param[in]  cell  Cell text
+   \param[out] value Parsed value
+
+   \return 0 on success; -1 if the cell is not numeric
+*/
+int top_cell_num(const char *cell, double *value);
+
+/** Check whether a line looks like data rather than a header, i.e. any
+    column except the first one is numeric
+
+   \param[in] line Line to check
+   \param[in] sep  Column separator
+*/
+bool top_line_is_data(const char *line, char sep);
+
+/** Get type of a cell
+
+   \param[in] cell Cell text
+
+   \return TOP_CELL_NONE for empty cells
+*/
+enum top_cell_type top_cell_type_get(const char *cell);
+
+/** Detect table schema
+
+   Column names are taken from the header, or from the first line if the
+   header is empty and the first line doesn't look like data. Column types
+   are the widest type found in all data lines.
+
+   \param[out] schema   Detected schema
+   \param[in]  line_get Line access function
+   \param[in]  arg      Argument of line_get
+   \param[in]  total    Number of lines
+*/
+void top_schema_detect(struct top_schema *schema, top_table_line_t *line_get,
+		       void *arg, int total);
+
+/** Write page in one of the machine readable formats
+
+   \param[in] ctx      Context
+   \param[in] stream   Output stream
+   \param[in] page_idx Page, fetched already
+*/
+void table_export(struct top_context *ctx, FILE *stream,
+		  unsigned int page_idx);
+
+#endif
@@ -0,0 +1,393 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_snapshot.h"
+#include "top_trigger.h"
+
+/** Maximum length of row key and column name of a condition */
+#define TRIGGER_NAME_LEN 64
+
+/** Snapshot ring of one page */
+struct trigger_ring {
+	/** Recorded page */
+	unsigned int page_idx;
+	/** Preallocated snapshots (pre + post) */
+	struct top_snapshot *slot;
+	/** Next slot to write */
+	unsigned int head;
+	/** Number of valid slots */
+	unsigned int count;
+};
+
+/** Trigger condition */
+struct trigger_cond {
+	unsigned int page_idx;
+	char row[TRIGGER_NAME_LEN];
+	char column[TRIGGER_NAME_LEN];
+	enum top_trigger_type type;
+	double lo, hi;
+	/** Value of the previous fetch */
+	double last;
+	bool last_valid;
+};
+
+struct top_trigger {
+	/** Pre-trigger window */
+	unsigned int pre;
+	/** Post-trigger window */
+	unsigned int post;
+	/** Snapshot size */
+	size_t snap_size;
+
+	struct trigger_ring ring[TOP_TRIGGER_PAGE_MAX];
+	unsigned int ring_num;
+
+	struct trigger_cond cond[TOP_TRIGGER_COND_MAX];
+	unsigned int cond_num;
+
+	/** Fired condition; -1 while armed */
+	int fired;
+	/** Value which fired the condition */
+	double fired_value;
+	/** Time of the trigger */
+	struct timeval fired_time;
+	/** Snapshots of the fired page still to record */
+	unsigned int post_left;
+};
+
+int top_trigger_init(struct top_context *ctx, unsigned int pre,
+		     unsigned int post, size_t snap_size)
+{
+	struct top_trigger *trg;
+
+	if (ctx->trigger || pre + post == 0)
+		return -1;
+
+	trg = malloc(sizeof(*trg));
+	if (!trg)
+		return -1;
+
+	memset(trg, 0, sizeof(*trg));
+	trg->pre = pre;
+	trg->post = post;
+	trg->snap_size = snap_size ? snap_size : TOP_TRIGGER_SNAP_SIZE;
+	trg->fired = -1;
+
+	ctx->trigger = trg;
+
+	return 0;
+}
+
+void top_trigger_shutdown(struct top_context *ctx)
+{
+	struct top_trigger *trg = ctx->trigger;
+	unsigned int i, k;
+
+	if (!trg)
+		return;
+
+	for (i = 0; i < trg->ring_num; i++) {
+		for (k = 0; k < trg->pre + trg->post; k++)
+			top_snapshot_free(&trg->ring[i].slot[k]);
+		free(trg->ring[i].slot);
+	}
+
+	free(trg);
+	ctx->trigger = NULL;
+}
+
+static struct trigger_ring *ring_get(struct top_trigger *trg,
+				     unsigned int page_idx)
+{
+	unsigned int i;
+
+	for (i = 0; i < trg->ring_num; i++)
+		if (trg->ring[i].page_idx == page_idx)
+			return &trg->ring[i];
+
+	return NULL;
+}
+
+int top_trigger_page_add(struct top_context *ctx, unsigned int page_idx)
+{
+	struct top_trigger *trg = ctx->trigger;
+	struct trigger_ring *ring;
+	unsigned int line_max, k;
+
+	if (!trg || page_idx >= ctx->page_num)
+		return -1;
+
+	if (ring_get(trg, page_idx))
+		return 0;
+
+	if (trg->ring_num == TOP_TRIGGER_PAGE_MAX)
+		return -1;
+
+	ring = &trg->ring[trg->ring_num];
+	memset(ring, 0, sizeof(*ring));
+	ring->page_idx = page_idx;
+	ring->slot = malloc(sizeof(*ring->slot) * (trg->pre + trg->post));
+	if (!ring->slot)
+		return -1;
+
+	/* assume lines of at least 16 characters on average */
+	line_max = trg->snap_size / 16;
+	if (line_max > TOP_LINE_MAX + 1)
+		line_max = TOP_LINE_MAX + 1;
+
+	for (k = 0; k < trg->pre + trg->post; k++) {
+		if (top_snapshot_init(&ring->slot[k], trg->snap_size,
+				      line_max, true) == 0)
+			continue;
+
+		while (k--)
+			top_snapshot_free(&ring->slot[k]);
+		free(ring->slot);
+		return -1;
+	}
+
+	trg->ring_num++;
+
+	return 0;
+}
+
+int top_trigger_cond_add(struct top_context *ctx, unsigned int page_idx,
+			 const char *row, const char *column,
+			 enum top_trigger_type type, double lo, double hi)
+{
+	struct top_trigger *trg = ctx->trigger;
+	struct trigger_cond *cond;
+
+	if (!trg || trg->cond_num == TOP_TRIGGER_COND_MAX)
+		return -1;
+
+	if (strlen(row) >= TRIGGER_NAME_LEN ||
+	    strlen(column) >= TRIGGER_NAME_LEN)
+		return -1;
+
+	if (top_trigger_page_add(ctx, page_idx))
+		return -1;
+
+	cond = &trg->cond[trg->cond_num];
+	memset(cond, 0, sizeof(*cond));
+	cond->page_idx = page_idx;
+	strcpy(cond->row, row);
+	strcpy(cond->column, column);
+	cond->type = type;
+	cond->lo = lo;
+	cond->hi = hi;
+
+	trg->cond_num++;
+
+	return 0;
+}
+
+/** Parse a numeric field of a condition; the whole field has to be a number
+
+   \return 0 on success; -1 on error
+*/
+static int value_parse(const char *field, double *value)
+{
+	char *end;
+
+	*value = strtod(field, &end);
+	if (end == field || *end)
+		return -1;
+
+	return 0;
+}
+
+int top_trigger_cond_parse(struct top_context *ctx, const char *spec)
+{
+	char buff[TOP_LINE_LEN];
+	char *field[6];
+	unsigned int n = 0;
+	char *p = buff;
+	double lo, hi;
+	int page_idx;
+
+	snprintf(buff, sizeof(buff), "%s", spec);
+
+	while (n < ARRAY_SIZE(field)) {
+		field[n++] = p;
+		p = strchr(p, ':');
+		if (!p)
+			break;
+		*p++ = 0;
+	}
+
+	/* too few fields or more than any condition has */
+	if (n < 5 || p)
+		return -1;
+
+	page_idx = top_page_find(ctx, field[0]);
+	if (page_idx < 0)
+		return -1;
+
+	if (n == 5 && strcmp(field[3], "delta") == 0) {
+		if (value_parse(field[4], &hi))
+			return -1;
+
+		return top_trigger_cond_add(ctx, page_idx, field[1], field[2],
+					    TOP_TRIGGER_DELTA, 0, hi);
+	}
+
+	if (n == 6 && strcmp(field[3], "range") == 0) {
+		if (value_parse(field[4], &lo) || value_parse(field[5], &hi))
+			return -1;
+
+		return top_trigger_cond_add(ctx, page_idx, field[1], field[2],
+					    TOP_TRIGGER_RANGE, lo, hi);
+	}
+
+	return -1;
+}
+
+bool trigger_page_is_recorded(struct top_context *ctx, unsigned int page_idx)
+{
+	return ctx->trigger && ring_get(ctx->trigger, page_idx) != NULL;
+}
+
+/** Check condition against the latest snapshot
+
+   \return true if the condition fired
+*/
+static bool cond_check(struct trigger_cond *cond,
+		       const struct top_snapshot *snap, double *value)
+{
+	bool fire = false;
+
+	if (top_snapshot_value_get(snap, cond->row, cond->column, value)) {
+		cond->last_valid = false;
+		return false;
+	}
+
+	switch (cond->type) {
+	case TOP_TRIGGER_DELTA:
+		fire = cond->last_valid && *value - cond->last > cond->hi;
+		break;
+	case TOP_TRIGGER_RANGE:
+		fire = *value < cond->lo || *value > cond->hi;
+		break;
+	}
+
+	cond->last = *value;
+	cond->last_valid = true;
+
+	return fire;
+}
+
+/** Write pre- and post-trigger windows of all recorded pages
+
+   \return 0 on success; 1 if the dump writer is busy; -1 if the dump can't
+           be written
+*/
+static int trigger_dump(struct top_context *ctx)
+{
+	struct top_trigger *trg = ctx->trigger;
+	struct trigger_cond *cond = &trg->cond[trg->fired];
+	char name[TOP_LINE_LEN];
+	unsigned int i, k, size = trg->pre + trg->post;
+	FILE *f;
+
+	snprintf(name, sizeof(name), "%lld_%lld_trigger.txt",
+		 (long long)trg->fired_time.tv_sec,
+		 (long long)trg->fired_time.tv_usec);
+
+	f = writer_open(ctx, name);
+	if (!f)
+		return errno == EBUSY ? 1 : -1;
+
+	fprintf(f, "Trigger: %s/%s/%s ", ctx->page[cond->page_idx].name,
+		cond->row, cond->column);
+	if (cond->type == TOP_TRIGGER_DELTA)
+		fprintf(f, "delta > %g", cond->hi);
+	else
+		fprintf(f, "outside %g..%g", cond->lo, cond->hi);
+	fprintf(f, ", value %g at %lld.%06ld" TOP_CRLF TOP_CRLF,
+		trg->fired_value,
+		(long long)trg->fired_time.tv_sec,
+		(long)trg->fired_time.tv_usec);
+
+	for (i = 0; i < trg->ring_num; i++) {
+		struct trigger_ring *ring = &trg->ring[i];
+
+		/* oldest snapshot first */
+		for (k = 0; k < ring->count; k++) {
+			top_snapshot_write(ctx, f,
+				&ring->slot[(ring->head + size - ring->count
+					     + k) % size]);
+			fprintf(f, TOP_CRLF);
+		}
+	}
+
+	writer_queue(ctx, f);
+
+	return 0;
+}
+
+void trigger_fetch_done(struct top_context *ctx, unsigned int page_idx)
+{
+	struct top_trigger *trg = ctx->trigger;
+	struct trigger_ring *ring;
+	struct top_snapshot *snap;
+	unsigned int i, size;
+	double value;
+	int ret;
+
+	ring = ring_get(trg, page_idx);
+	if (!ring)
+		return;
+
+	size = trg->pre + trg->post;
+	snap = &ring->slot[ring->head];
+	(void)top_snapshot_capture(ctx, page_idx, snap);
+	ring->head = (ring->head + 1) % size;
+	if (ring->count < size)
+		ring->count++;
+
+	if (trg->fired >= 0 && trg->cond[trg->fired].page_idx == page_idx &&
+	    trg->post_left)
+		trg->post_left--;
+
+	for (i = 0; i < trg->cond_num; i++) {
+		if (trg->cond[i].page_idx != page_idx)
+			continue;
+
+		/* keep the previous values up to date while recording */
+		if (!cond_check(&trg->cond[i], snap, &value) || trg->fired >= 0)
+			continue;
+
+		trg->fired = i;
+		trg->fired_value = value;
+		trg->fired_time = snap->time;
+		trg->post_left = trg->post;
+	}
+
+	if (trg->fired < 0 || trg->post_left)
+		return;
+
+	/* retry with the next fetch if the writer is busy */
+	ret = trigger_dump(ctx);
+	if (ret > 0)
+		return;
+
+	/* the writer status tells about the failure; the windows of the
+	 * lost dump aren't reused for the next one */
+	if (ret < 0)
+		for (i = 0; i < trg->ring_num; i++)
+			trg->ring[i].count = 0;
+
+	trg->fired = -1;
+}
+
+#endif
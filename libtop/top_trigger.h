@@ -0,0 +1,89 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_trigger_h
+#define __top_trigger_h
+
+/** Maximum number of pages recorded by the trigger engine */
+#define TOP_TRIGGER_PAGE_MAX 8
+
+/** Maximum number of trigger conditions */
+#define TOP_TRIGGER_COND_MAX 16
+
+/** Default snapshot buffer size of a recorded page */
+#define TOP_TRIGGER_SNAP_SIZE (64 * 1024)
+
+struct top_context;
+
+/** Trigger condition type */
+enum top_trigger_type {
+	/** Value increased by more than the threshold since last fetch */
+	TOP_TRIGGER_DELTA,
+	/** Value is outside of the configured range */
+	TOP_TRIGGER_RANGE
+};
+
+/** Enable trigger engine
+
+   \param[in] ctx       Context
+   \param[in] pre       Number of snapshots kept before the trigger
+   \param[in] post      Number of snapshots recorded after the trigger
+   \param[in] snap_size Snapshot buffer size of each recorded page;
+                        0 for TOP_TRIGGER_SNAP_SIZE
+
+   \return 0 on success; -1 on error
+*/
+int top_trigger_init(struct top_context *ctx, unsigned int pre,
+		     unsigned int post, size_t snap_size);
+
+/** Disable trigger engine and release its memory */
+void top_trigger_shutdown(struct top_context *ctx);
+
+/** Record page into the trigger ring (pages used in conditions are
+    recorded automatically)
+
+   \return 0 on success; -1 on error
+*/
+int top_trigger_page_add(struct top_context *ctx, unsigned int page_idx);
+
+/** Add trigger condition
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page of the watched value
+   \param[in] row      Row key (text of the first column)
+   \param[in] column   Column name or "#<n>"
+   \param[in] type     Condition type
+   \param[in] lo       Lower range limit (TOP_TRIGGER_RANGE only)
+   \param[in] hi       Upper range limit or delta threshold
+
+   \return 0 on success; -1 on error
+*/
+int top_trigger_cond_add(struct top_context *ctx, unsigned int page_idx,
+			 const char *row, const char *column,
+			 enum top_trigger_type type, double lo, double hi);
+
+/** Add trigger condition given as text
+
+   Supported formats:
+   - "<page>:<row>:<column>:delta:<threshold>"
+   - "<page>:<row>:<column>:range:<lo>:<hi>"
+
+   where page is a page key or name as accepted by top_select_group.
+
+   \return 0 on success; -1 on error
+*/
+int top_trigger_cond_parse(struct top_context *ctx, const char *spec);
+
+/** Check whether page is recorded by the trigger engine */
+bool trigger_page_is_recorded(struct top_context *ctx, unsigned int page_idx);
+
+/** Record fetched page and evaluate its conditions; called after each
+    counters fetch */
+void trigger_fetch_done(struct top_context *ctx, unsigned int page_idx);
+
+#endif
@@ -0,0 +1,425 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_table.h"
+#include "top_watch.h"
+
+#include <ctype.h>
+#ifdef LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/** Maximum length of the path a pinned row is read from */
+#define WATCH_PATH_LEN (TOP_PROC_ROOT_LEN + TOP_LINE_LEN)
+
+/** Pinned row */
+struct watch_pin {
+	unsigned int page_idx;
+	/** Row key */
+	char row[TOP_WATCH_ROW_LEN];
+	/** Row text of the last fetch; empty if the row wasn't found */
+	char text[TOP_LINE_LEN];
+
+	/** File the page is read from; empty if the page is fetched as a
+	    whole */
+	char path[WATCH_PATH_LEN];
+	/** First pin of the same file (or page) in the running fetch */
+	unsigned int file;
+	/** Row was found by the running fetch */
+	bool done;
+};
+
+struct top_watch {
+	struct watch_pin pin[TOP_WATCH_PIN_MAX];
+	unsigned int pin_num;
+};
+
+static bool is_watch_page(const struct top_page_desc *page)
+{
+	return page->page_get == watch_get;
+}
+
+static struct watch_pin *pin_find(struct top_watch *w, unsigned int page_idx,
+				  const char *row)
+{
+	unsigned int i;
+
+	for (i = 0; w && i < w->pin_num; i++)
+		if (w->pin[i].page_idx == page_idx &&
+		    strcmp(w->pin[i].row, row) == 0)
+			return &w->pin[i];
+
+	return NULL;
+}
+
+int top_watch_pin(struct top_context *ctx, unsigned int page_idx,
+		  const char *row)
+{
+	struct top_watch *w = ctx->watch;
+	struct watch_pin *pin;
+
+	if (page_idx >= ctx->page_num || is_watch_page(&ctx->page[page_idx]))
+		return -1;
+
+	if (!ctx->page[page_idx].page_get && !ctx->page[page_idx].source)
+		return -1;
+
+	if (!row[0] || strlen(row) >= TOP_WATCH_ROW_LEN)
+		return -1;
+
+	if (pin_find(w, page_idx, row))
+		return 0;
+
+	if (!w) {
+		w = calloc(1, sizeof(*w));
+		if (!w)
+			return -1;
+
+		ctx->watch = w;
+	}
+
+	if (w->pin_num == TOP_WATCH_PIN_MAX)
+		return -1;
+
+	pin = &w->pin[w->pin_num++];
+	memset(pin, 0, sizeof(*pin));
+	pin->page_idx = page_idx;
+	strcpy(pin->row, row);
+
+	return 0;
+}
+
+int top_watch_pin_parse(struct top_context *ctx, const char *spec)
+{
+	char buff[TOP_LINE_LEN];
+	int page_idx;
+	char *row;
+
+	snprintf(buff, sizeof(buff), "%s", spec);
+
+	row = strchr(buff, ':');
+	if (!row)
+		return -1;
+	*row++ = 0;
+
+	page_idx = top_page_find(ctx, buff);
+	if (page_idx < 0)
+		return -1;
+
+	return top_watch_pin(ctx, page_idx, row);
+}
+
+int top_watch_unpin(struct top_context *ctx, unsigned int page_idx,
+		    const char *row)
+{
+	struct top_watch *w = ctx->watch;
+	struct watch_pin *pin;
+
+	pin = pin_find(w, page_idx, row);
+	if (!pin)
+		return -1;
+
+	memmove(pin, pin + 1, (char *)&w->pin[w->pin_num] - (char *)(pin + 1));
+	w->pin_num--;
+
+	return 0;
+}
+
+void top_watch_shutdown(struct top_context *ctx)
+{
+	free(ctx->watch);
+	ctx->watch = NULL;
+}
+
+/** Check whether the first column of a line is the row key
+
+   \param[in] line    Line, not terminated
+   \param[in] len     Line length
+   \param[in] sep     Column separator as returned by top_columns_sep
+   \param[in] row     Row key
+   \param[in] row_len Length of the row key
+*/
+static bool row_match(const char *line, size_t len, char sep,
+		      const char *row, size_t row_len)
+{
+	const char *end = line + len;
+
+	while (line < end && isspace((unsigned char)*line))
+		line++;
+
+	if ((size_t)(end - line) < row_len || memcmp(line, row, row_len))
+		return false;
+
+	line += row_len;
+
+	if (sep == TOP_SEP_SPACE)
+		return line == end || isspace((unsigned char)*line);
+
+	/* the columns are trimmed */
+	while (line < end && *line != sep && isspace((unsigned char)*line))
+		line++;
+
+	return line == end || *line == sep;
+}
+
+/** Match line against the rows still missing from one file
+
+   \return Number of rows found
+*/
+static unsigned int line_scan(struct top_watch *w, unsigned int file,
+			      const char *line, size_t len, char sep)
+{
+	struct watch_pin *pin;
+	unsigned int i, found = 0;
+
+	for (i = file; i < w->pin_num; i++) {
+		pin = &w->pin[i];
+		if (pin->file != file || pin->done ||
+		    !row_match(line, len, sep, pin->row, strlen(pin->row)))
+			continue;
+
+		if (len >= sizeof(pin->text))
+			len = sizeof(pin->text) - 1;
+		while (len && line[len - 1] == '\r')
+			len--;
+
+		memcpy(pin->text, line, len);
+		pin->text[len] = 0;
+		pin->done = true;
+		found++;
+	}
+
+	return found;
+}
+
+/** Get separator of a table from its first line */
+static char line_sep(const char *line, size_t len)
+{
+	char buff[TOP_LINE_LEN];
+
+	snprintf(buff, sizeof(buff), "%.*s", (int)len, line);
+
+	return top_columns_sep(buff);
+}
+
+#ifdef LINUX
+/** Read file up to the last pinned row; the lines are only compared with
+    the row keys
+
+   \param[in] ctx  Context
+   \param[in] w    Watch list
+   \param[in] file First pin of the file
+   \param[in] left Number of pins of the file
+*/
+static void file_scan(struct top_context *ctx, struct top_watch *w,
+		      unsigned int file, unsigned int left)
+{
+	char *buff = &ctx->shared_buff[0][0];
+	size_t size = sizeof(ctx->shared_buff), s = 0, pos = 0;
+	char sep = TOP_SEP_SPACE;
+	ssize_t n;
+	char *nl;
+	int fd;
+
+	fd = open(w->pin[file].path, O_RDONLY);
+	ctx->prof.syscalls++;
+	if (fd < 0)
+		return;
+
+	while (left && s < size) {
+		n = read(fd, buff + s, size - s);
+		if (n < 0 && errno == EINTR)
+			continue;
+		prof_read(ctx, n > 0 ? n : 0);
+		if (n <= 0)
+			break;
+		s += n;
+
+		while (left && (nl = memchr(buff + pos, '\n', s - pos))) {
+			if (pos == 0)
+				sep = line_sep(buff, nl - buff);
+
+			left -= line_scan(w, file, buff + pos,
+					  nl - buff - pos, sep);
+			pos = nl - buff + 1;
+		}
+	}
+
+	/* last line without line end */
+	if (left && pos < s) {
+		if (pos == 0)
+			sep = line_sep(buff, s);
+
+		(void)line_scan(w, file, buff + pos, s - pos, sep);
+	}
+
+	close(fd);
+	ctx->prof.syscalls++;
+}
+#endif
+
+/** Fetch page as a whole and look up its pinned rows
+
+   \param[in] ctx  Context
+   \param[in] w    Watch list
+   \param[in] file First pin of the page
+   \param[in] left Number of pins of the page
+*/
+static void page_scan(struct top_context *ctx, struct top_watch *w,
+		      unsigned int file, unsigned int left)
+{
+	const struct top_page_desc *page = &ctx->page[w->pin[file].page_idx];
+	char buff[TOP_LINE_LEN];
+	char sep = TOP_SEP_SPACE;
+	const char *p;
+	int total, line;
+
+#ifdef LINUX
+	if (page->source)
+		total = source_fetch(ctx, w->pin[file].page_idx);
+	else
+#endif
+		total = page->page_get(ctx, page->input_file_name);
+
+	for (line = 0; line < total && left; line++) {
+		buff[0] = 0;
+		p = page->line_get(ctx, line, buff);
+		if (!p)
+			p = buff;
+
+		if (line == 0)
+			sep = top_columns_sep(p);
+
+		left -= line_scan(w, file, p, strlen(p), sep);
+	}
+}
+
+/** Assign the pins to the files they are read from */
+static void pins_group(struct top_context *ctx, struct top_watch *w)
+{
+	struct watch_pin *pin;
+	unsigned int i, k;
+
+	for (i = 0; i < w->pin_num; i++) {
+		pin = &w->pin[i];
+		pin->text[0] = 0;
+		pin->done = false;
+		pin->file = i;
+
+#ifdef LINUX
+		if (linux_page_path(ctx, pin->page_idx, pin->path,
+				    sizeof(pin->path)))
+#endif
+			pin->path[0] = 0;
+
+		for (k = 0; k < i; k++) {
+			if (strcmp(pin->path, w->pin[k].path) ||
+			    (!pin->path[0] &&
+			     pin->page_idx != w->pin[k].page_idx))
+				continue;
+
+			pin->file = w->pin[k].file;
+			break;
+		}
+	}
+}
+
+int watch_get(struct top_context *ctx, const char *dummy)
+{
+	struct top_watch *w = ctx->watch;
+	struct watch_pin *pin;
+	uint64_t hash[2] = { 0, 0 };
+	unsigned int i, k, left;
+	int n;
+
+	if (w) {
+		pins_group(ctx, w);
+
+		for (i = 0; i < w->pin_num; i++) {
+			if (w->pin[i].file != i)
+				continue;
+
+			for (k = i, left = 0; k < w->pin_num; k++)
+				if (w->pin[k].file == i)
+					left++;
+
+#ifdef LINUX
+			if (w->pin[i].path[0])
+				file_scan(ctx, w, i, left);
+			else
+#endif
+				page_scan(ctx, w, i, left);
+		}
+	}
+
+	/* the rows are copied out already */
+	ctx->line_cache[0] = NULL;
+
+	if (!w || !w->pin_num) {
+		snprintf(ctx->shared_buff[0], TOP_LINE_LEN,
+			 "No rows pinned; Ctrl-p pins the top row of a page");
+		n = 1;
+	} else {
+		for (n = 0; n < (int)w->pin_num && n < TOP_LINE_MAX; n++) {
+			pin = &w->pin[n];
+			if (pin->done)
+				snprintf(ctx->shared_buff[n], TOP_LINE_LEN,
+					 "%-16.16s %s",
+					 ctx->page[pin->page_idx].name,
+					 pin->text);
+			else
+				snprintf(ctx->shared_buff[n], TOP_LINE_LEN,
+					 "%-16.16s %s (not found)",
+					 ctx->page[pin->page_idx].name,
+					 pin->row);
+		}
+	}
+
+	/* lets unchanged rows skip the redraw */
+	for (i = 0; i < (unsigned int)n; i++) {
+		hash[1] = top_hash(ctx->shared_buff[i],
+				   strlen(ctx->shared_buff[i]));
+		hash[0] = top_hash(hash, sizeof(hash));
+	}
+
+	ctx->fetch_hash = hash[0];
+	ctx->fetch_reused = false;
+	/* the text of the pinned pages was overwritten */
+	ctx->parsed_size = 0;
+
+	return n;
+}
+
+int watch_toggle(struct top_context *ctx, unsigned int page_idx, int line,
+		 const char *text)
+{
+	struct top_watch *w = ctx->watch;
+	char buff[TOP_LINE_LEN];
+	char *col[1];
+
+	if (is_watch_page(&ctx->page[page_idx])) {
+		if (!w || line < 0 || line >= (int)w->pin_num)
+			return -1;
+
+		return top_watch_unpin(ctx, w->pin[line].page_idx,
+				       w->pin[line].row);
+	}
+
+	if (!text || top_columns_split(text, top_columns_sep(text), buff, col,
+				       ARRAY_SIZE(col)) < 1)
+		return -1;
+
+	if (top_watch_unpin(ctx, page_idx, col[0]) == 0)
+		return 0;
+
+	return top_watch_pin(ctx, page_idx, col[0]);
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_watch_h
+#define __top_watch_h
+
+/** Maximum number of pinned rows */
+#define TOP_WATCH_PIN_MAX 32
+
+/** Maximum length of a row key */
+#define TOP_WATCH_ROW_LEN 64
+
+/** Update interval (in ms) of the watch page */
+#define TOP_WATCH_INTERVAL 100
+
+struct top_context;
+
+/** Pin row to the watch page
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page of the row
+   \param[in] row      Row key (text of the first column)
+
+   \return 0 on success; -1 on error
+*/
+int top_watch_pin(struct top_context *ctx, unsigned int page_idx,
+		  const char *row);
+
+/** Pin row given as "<page>:<row>", where page is a page key or name as
+    accepted by top_select_group
+
+   \return 0 on success; -1 on error
+*/
+int top_watch_pin_parse(struct top_context *ctx, const char *spec);
+
+/** Remove row from the watch page
+
+   \return 0 on success; -1 if the row isn't pinned
+*/
+int top_watch_unpin(struct top_context *ctx, unsigned int page_idx,
+		    const char *row);
+
+/** Remove all pins and release their memory */
+void top_watch_shutdown(struct top_context *ctx);
+
+/** Get the pinned rows (page_get handler of the watch page)
+
+   Every file is read once for all of its pinned rows and only until the
+   last of them is found; the other rows aren't parsed.
+
+   \return Number of lines
+*/
+int watch_get(struct top_context *ctx, const char *dummy);
+
+/** Pin the row shown in the top line of a page or, on the watch page,
+    remove it
+
+   \param[in] ctx      Context
+   \param[in] page_idx Page
+   \param[in] line     Line number of the row
+   \param[in] text     Line text
+
+   \return 0 on success; -1 on error
+*/
+int watch_toggle(struct top_context *ctx, unsigned int page_idx, int line,
+		 const char *text);
+
+#endif
@@ -0,0 +1,350 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifdef LINUX
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/** Dump buffer state */
+enum writer_buf_state {
+	WRITER_BUF_FREE,
+	/** Being filled by the UI */
+	WRITER_BUF_FILL,
+	/** Waiting for (or being written by) the writer thread */
+	WRITER_BUF_QUEUED
+};
+
+/** Dump buffer */
+struct writer_buf {
+	enum writer_buf_state state;
+	/** Order of queuing */
+	unsigned int seq;
+	/** Memory stream filling data */
+	FILE *f;
+	char *data;
+	size_t len;
+	/** Destination file */
+	char path[TOP_DUMP_DIR_LEN + TOP_LINE_LEN];
+	enum top_fsync_policy fsync;
+};
+
+struct top_writer {
+	pthread_t thread;
+	bool thread_running;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	bool stop;
+
+	/** Double buffer; one is filled while the other one is written */
+	struct writer_buf buf[2];
+	unsigned int seq;
+	/** Destination of a dump written without the writer thread */
+	char direct_path[TOP_DUMP_DIR_LEN + TOP_LINE_LEN];
+
+	/** Result of the last dump */
+	char status[TOP_DUMP_DIR_LEN + TOP_LINE_LEN + 64];
+	struct timeval status_time;
+};
+
+void top_dump_dir_set(struct top_context *ctx, const char *dir)
+{
+	snprintf(ctx->dump_dir, sizeof(ctx->dump_dir), "%s", dir);
+}
+
+void top_dump_fsync_set(struct top_context *ctx, enum top_fsync_policy policy)
+{
+	ctx->dump_fsync = policy;
+}
+
+/** Sync dump file according to the policy */
+static int file_sync(int fd, const char *path, enum top_fsync_policy policy)
+{
+	char dir[TOP_DUMP_DIR_LEN + TOP_LINE_LEN];
+	char *p;
+	int ret = 0;
+
+	if (policy == TOP_FSYNC_NONE)
+		return 0;
+
+	if (fsync(fd))
+		return -1;
+
+	if (policy != TOP_FSYNC_DIR)
+		return 0;
+
+	snprintf(dir, sizeof(dir), "%s", path);
+	p = strrchr(dir, '/');
+	if (!p)
+		strcpy(dir, ".");
+	else if (p == dir)
+		p[1] = 0;
+	else
+		*p = 0;
+
+	fd = open(dir, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	if (fsync(fd))
+		ret = -1;
+	close(fd);
+
+	return ret;
+}
+
+/** Write buffer into file */
+static int buf_write(struct writer_buf *buf)
+{
+	size_t off = 0;
+	ssize_t n;
+	int fd, ret = 0;
+
+	fd = open(buf->path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return -1;
+
+	while (off < buf->len) {
+		n = write(fd, buf->data + off, buf->len - off);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0) {
+			ret = -1;
+			break;
+		}
+		off += n;
+	}
+
+	if (ret == 0)
+		ret = file_sync(fd, buf->path, buf->fsync);
+
+	if (close(fd))
+		ret = -1;
+
+	return ret;
+}
+
+static void status_set(struct top_writer *wr, int err, const char *path)
+{
+	snprintf(wr->status, sizeof(wr->status),
+		 err ? "Can't save counters to '%s'" : "Saved to '%s'", path);
+	top_time_get(&wr->status_time);
+}
+
+static struct writer_buf *buf_next(struct top_writer *wr)
+{
+	struct writer_buf *next = NULL;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(wr->buf); i++) {
+		if (wr->buf[i].state != WRITER_BUF_QUEUED)
+			continue;
+		if (!next || (int)(wr->buf[i].seq - next->seq) < 0)
+			next = &wr->buf[i];
+	}
+
+	return next;
+}
+
+static void *writer_thread(void *arg)
+{
+	struct top_writer *wr = arg;
+	struct writer_buf *buf;
+	int err;
+
+	pthread_mutex_lock(&wr->lock);
+	while (1) {
+		buf = buf_next(wr);
+		if (!buf) {
+			if (wr->stop)
+				break;
+			pthread_cond_wait(&wr->cond, &wr->lock);
+			continue;
+		}
+
+		/* the UI doesn't touch queued buffers */
+		pthread_mutex_unlock(&wr->lock);
+		err = buf_write(buf);
+		pthread_mutex_lock(&wr->lock);
+
+		status_set(wr, err, buf->path);
+		free(buf->data);
+		buf->data = NULL;
+		buf->len = 0;
+		buf->state = WRITER_BUF_FREE;
+	}
+	pthread_mutex_unlock(&wr->lock);
+
+	return NULL;
+}
+
+int writer_init(struct top_context *ctx)
+{
+	struct top_writer *wr;
+
+	if (ctx->writer)
+		return 0;
+
+	wr = malloc(sizeof(*wr));
+	if (!wr)
+		return -1;
+
+	memset(wr, 0, sizeof(*wr));
+	pthread_mutex_init(&wr->lock, NULL);
+	pthread_cond_init(&wr->cond, NULL);
+
+	ctx->writer = wr;
+
+	if (pthread_create(&wr->thread, NULL, writer_thread, wr))
+		return -1;
+
+	wr->thread_running = true;
+
+	return 0;
+}
+
+void writer_shutdown(struct top_context *ctx)
+{
+	struct top_writer *wr = ctx->writer;
+
+	if (!wr)
+		return;
+
+	if (wr->thread_running) {
+		pthread_mutex_lock(&wr->lock);
+		wr->stop = true;
+		pthread_cond_signal(&wr->cond);
+		pthread_mutex_unlock(&wr->lock);
+
+		pthread_join(wr->thread, NULL);
+	}
+
+	pthread_cond_destroy(&wr->cond);
+	pthread_mutex_destroy(&wr->lock);
+	free(wr);
+	ctx->writer = NULL;
+}
+
+FILE *writer_open(struct top_context *ctx, const char *name)
+{
+	struct top_writer *wr = ctx->writer;
+	struct writer_buf *buf = NULL;
+	char path[TOP_DUMP_DIR_LEN + TOP_LINE_LEN];
+	unsigned int i;
+
+	snprintf(path, sizeof(path), "%s/%s", ctx->dump_dir, name);
+
+	if (!wr || !wr->thread_running) {
+		FILE *f = fopen(path, "w");
+
+		if (wr) {
+			strcpy(wr->direct_path, path);
+			if (!f)
+				status_set(wr, -1, path);
+		}
+		return f;
+	}
+
+	pthread_mutex_lock(&wr->lock);
+	for (i = 0; i < ARRAY_SIZE(wr->buf); i++) {
+		if (wr->buf[i].state == WRITER_BUF_FREE) {
+			buf = &wr->buf[i];
+			buf->state = WRITER_BUF_FILL;
+			break;
+		}
+	}
+	if (!buf) {
+		snprintf(wr->status, sizeof(wr->status),
+			 "Dump writer busy, '%s' not saved", path);
+		top_time_get(&wr->status_time);
+	}
+	pthread_mutex_unlock(&wr->lock);
+
+	if (!buf) {
+		errno = EBUSY;
+		return NULL;
+	}
+
+	strcpy(buf->path, path);
+	buf->fsync = ctx->dump_fsync;
+	buf->f = open_memstream(&buf->data, &buf->len);
+	if (!buf->f) {
+		pthread_mutex_lock(&wr->lock);
+		buf->state = WRITER_BUF_FREE;
+		status_set(wr, -1, path);
+		pthread_mutex_unlock(&wr->lock);
+	}
+
+	return buf->f;
+}
+
+void writer_queue(struct top_context *ctx, FILE *f)
+{
+	struct top_writer *wr = ctx->writer;
+	unsigned int i;
+	int err;
+
+	for (i = 0; wr && i < ARRAY_SIZE(wr->buf); i++) {
+		struct writer_buf *buf = &wr->buf[i];
+
+		/* set only while the UI fills the buffer */
+		if (buf->f != f)
+			continue;
+
+		fclose(f);
+		buf->f = NULL;
+
+		pthread_mutex_lock(&wr->lock);
+		buf->seq = wr->seq++;
+		buf->state = WRITER_BUF_QUEUED;
+		pthread_cond_signal(&wr->cond);
+		pthread_mutex_unlock(&wr->lock);
+		return;
+	}
+
+	/* opened directly; the directory is only known with a writer */
+	err = fflush(f);
+	if (err == 0)
+		err = file_sync(fileno(f), wr ? wr->direct_path : "",
+				!wr && ctx->dump_fsync == TOP_FSYNC_DIR ?
+				TOP_FSYNC_FILE : ctx->dump_fsync);
+	if (fclose(f))
+		err = -1;
+
+	if (wr)
+		status_set(wr, err, wr->direct_path);
+}
+
+bool writer_status_get(struct top_context *ctx, char *buff, size_t size)
+{
+	struct top_writer *wr = ctx->writer;
+	struct timeval tv;
+	bool ret = false;
+
+	if (!wr)
+		return false;
+
+	top_time_get(&tv);
+
+	pthread_mutex_lock(&wr->lock);
+	if (wr->status[0] &&
+	    tv.tv_sec - wr->status_time.tv_sec < TOP_WRITER_STATUS_TIME) {
+		snprintf(buff, size, "%s", wr->status);
+		ret = true;
+	}
+	pthread_mutex_unlock(&wr->lock);
+
+	return ret;
+}
+
+#endif
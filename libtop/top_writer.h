@@ -0,0 +1,75 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __top_writer_h
+#define __top_writer_h
+
+/** Default directory for the counter dumps */
+#define TOP_DUMP_DIR_DEFAULT "/tmp"
+
+/** Maximum length of the dump directory path */
+#define TOP_DUMP_DIR_LEN 256
+
+/** Time (in s) the writer status is shown in the footer */
+#define TOP_WRITER_STATUS_TIME 5
+
+struct top_context;
+
+/** Flush policy of the dump files */
+enum top_fsync_policy {
+	/** Leave writing back to the kernel */
+	TOP_FSYNC_NONE,
+	/** Sync file data before closing the file */
+	TOP_FSYNC_FILE,
+	/** Sync file data and the directory entry */
+	TOP_FSYNC_DIR
+};
+
+/** Set directory for the counter dumps */
+void top_dump_dir_set(struct top_context *ctx, const char *dir);
+
+/** Set flush policy for the counter dumps */
+void top_dump_fsync_set(struct top_context *ctx, enum top_fsync_policy policy);
+
+/** Start dump writer thread
+
+   \return 0 on success; -1 on error (dumps are written synchronously)
+*/
+int writer_init(struct top_context *ctx);
+
+/** Write pending dumps and stop writer thread */
+void writer_shutdown(struct top_context *ctx);
+
+/** Open dump
+
+   If the writer thread runs, the returned stream writes to one of its two
+   memory buffers; otherwise the dump file is opened directly.
+
+   \param[in] ctx  Context
+   \param[in] name File name inside the dump directory
+
+   \return Stream for the dump contents; NULL if both buffers are busy
+           (errno is EBUSY) or the file can't be opened
+*/
+FILE *writer_open(struct top_context *ctx, const char *name);
+
+/** Close dump opened with \ref writer_open and hand it over to the writer
+    thread */
+void writer_queue(struct top_context *ctx, FILE *f);
+
+/** Get status of the last completed dump
+
+   \param[in]  ctx  Context
+   \param[out] buff Status text
+   \param[in]  size Size of buff
+
+   \return true if there is a recent status to show
+*/
+bool writer_status_get(struct top_context *ctx, char *buff, size_t size);
+
+#endif
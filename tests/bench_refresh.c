@@ -0,0 +1,269 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* Refresh path benchmark: a synthetic table is refreshed and scrolled
+   through the main loop with the recording backend; every page size runs
+   in its own process so the memory figures don't add up.
+
+   Usage: bench_refresh [rows ...] */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "procgen.h"
+
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/** Number of columns of the synthetic table */
+#define BENCH_COLS 8
+
+/** Terminal size */
+#define BENCH_ROWS 40
+#define BENCH_TERM_COLS 132
+
+/** Table rows read per scenario and phase (bounds the run time) */
+#define BENCH_ROW_BUDGET 2000000
+
+#define BENCH_KEYS_MIN 20
+#define BENCH_KEYS_MAX 1000
+
+/** Next page key sequence */
+#define BENCH_KEY_NPAGE "\033[6~"
+
+struct scenario {
+	const char *name;
+	unsigned int rows;
+};
+
+static const struct scenario scenario_default[] = {
+	{ "small", 20 },
+	{ "medium", 1000 },
+	{ "large", 50000 },
+};
+
+static const struct top_page_desc page[] = {
+	ONU_CNT_PROC(0, 'a', "bench", "bench")
+};
+
+struct phase_result {
+	double frames_per_sec;
+	uint32_t p50, p99;
+	uint64_t mean;
+	uint64_t bytes_per_frame;
+	uint64_t calls_per_frame;
+};
+
+static uint64_t calls_sum(const struct top_record *rec)
+{
+	uint64_t sum = 0;
+	unsigned int i;
+
+	for (i = 0; i < TOP_RECORD_OP_NUM; i++)
+		sum += rec->calls[i];
+
+	return sum;
+}
+
+/** Run the main loop with scripted keys */
+static void phase_run(struct top_context *ctx, struct top_record *rec,
+		      const char *keys, size_t len, struct phase_result *res)
+{
+	uint64_t start, elapsed;
+
+	top_record_reset(rec);
+	top_record_keys(rec, keys, len);
+
+	start = top_time_us();
+	top_ui_main_loop(ctx);
+	elapsed = top_time_us() - start;
+
+	memset(res, 0, sizeof(*res));
+	if (!rec->frames)
+		return;
+
+	res->frames_per_sec = elapsed ? rec->frames * 1e6 / elapsed : 0;
+	res->p50 = top_hist_percentile(&rec->latency, 50);
+	res->p99 = top_hist_percentile(&rec->latency, 99);
+	res->mean = rec->latency.count ?
+		    rec->latency.sum / rec->latency.count : 0;
+	res->bytes_per_frame = rec->bytes / rec->frames;
+	res->calls_per_frame = calls_sum(rec) / rec->frames;
+}
+
+static char *keys_repeat(const char *key, unsigned int num, size_t *len)
+{
+	size_t key_len = strlen(key);
+	unsigned int i;
+	char *keys;
+
+	keys = malloc(key_len * num);
+	if (!keys)
+		return NULL;
+
+	for (i = 0; i < num; i++)
+		memcpy(keys + i * key_len, key, key_len);
+
+	*len = key_len * num;
+
+	return keys;
+}
+
+static int scenario_run(const struct scenario *s, const char *root, FILE *out)
+{
+	struct phase_result refresh, nav;
+	struct top_context *ctx;
+	struct top_record rec;
+	struct rusage usage;
+	unsigned int num;
+	char *keys;
+	size_t len;
+	int lines;
+
+	if (procgen_table(root, page[0].input_file_name, s->rows, BENCH_COLS,
+			  0))
+		return -1;
+
+	num = BENCH_ROW_BUDGET / (s->rows + 1);
+	if (num < BENCH_KEYS_MIN)
+		num = BENCH_KEYS_MIN;
+	if (num > BENCH_KEYS_MAX)
+		num = BENCH_KEYS_MAX;
+
+	ctx = malloc(sizeof(*ctx));
+	if (!ctx)
+		return -1;
+
+	top_record_init(&rec, BENCH_ROWS, BENCH_TERM_COLS);
+
+	/* the update timer must not add frames */
+	if (top_init(ctx, &record_top_ops, -1, page, ARRAY_SIZE(page), NULL, 0,
+		     3600 * 1000, NULL, NULL, &rec) ||
+	    top_proc_root_set(ctx, root)) {
+		free(ctx);
+		return -1;
+	}
+
+	top_ui_prepare(ctx);
+
+	/* every page key press fetches and redraws the page */
+	keys = keys_repeat("a", num, &len);
+	if (!keys)
+		goto fail;
+	phase_run(ctx, &rec, keys, len, &refresh);
+	free(keys);
+
+	lines = ctx->page_state[0].total;
+
+	/* navigation only redraws */
+	keys = keys_repeat(BENCH_KEY_NPAGE, num, &len);
+	if (!keys)
+		goto fail;
+	phase_run(ctx, &rec, keys, len, &nav);
+	free(keys);
+
+	top_ui_shutdown(ctx);
+	top_shutdown(ctx);
+	free(ctx);
+
+	getrusage(RUSAGE_SELF, &usage);
+
+	fprintf(out, "%-8s %6u %6d %10.1f %7u %7u %9.1f %7u %7u %8llu %6llu "
+		"%8ld\n",
+		s->name, s->rows, lines,
+		refresh.frames_per_sec, refresh.p50, refresh.p99,
+		nav.frames_per_sec, nav.p50, nav.p99,
+		(unsigned long long)refresh.bytes_per_frame,
+		(unsigned long long)refresh.calls_per_frame,
+		usage.ru_maxrss);
+
+	return 0;
+
+fail:
+	top_ui_shutdown(ctx);
+	top_shutdown(ctx);
+	free(ctx);
+	return -1;
+}
+
+/** Run scenario in a child process */
+static int scenario_fork(const struct scenario *s, const char *root)
+{
+	pid_t pid;
+	FILE *out;
+	int status;
+
+	fflush(stdout);
+
+	pid = fork();
+	if (pid < 0)
+		return -1;
+
+	if (pid == 0) {
+		/* top_ui_shutdown writes to stdout */
+		out = fdopen(dup(STDOUT_FILENO), "w");
+		if (!out || !freopen("/dev/null", "w", stdout))
+			_exit(1);
+
+		status = scenario_run(s, root, out);
+		fclose(out);
+		_exit(status ? 1 : 0);
+	}
+
+	if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) ||
+	    WEXITSTATUS(status))
+		return -1;
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	struct scenario custom;
+	char root[64];
+	unsigned int i;
+	int ret = 0;
+
+	if (procgen_root_create(root, sizeof(root))) {
+		fprintf(stderr, "can't create proc root\n");
+		return 1;
+	}
+
+	printf("context: %zu bytes, line max %d, line len %d, %d columns\n",
+	       sizeof(struct top_context), TOP_LINE_MAX, TOP_LINE_LEN,
+	       BENCH_COLS);
+	printf("latencies are keypress-to-frame in us "
+	       "(upper bound of the histogram bucket)\n\n");
+	printf("%-8s %6s %6s %10s %7s %7s %9s %7s %7s %8s %6s %8s\n",
+	       "page", "rows", "lines", "refresh/s", "p50", "p99",
+	       "scroll/s", "p50", "p99", "B/frame", "calls", "rss_kb");
+
+	if (argc > 1) {
+		for (i = 1; i < (unsigned int)argc; i++) {
+			custom.name = "custom";
+			custom.rows = strtoul(argv[i], NULL, 0);
+			if (scenario_fork(&custom, root)) {
+				fprintf(stderr, "%s rows: failed\n", argv[i]);
+				ret = 1;
+			}
+		}
+	} else {
+		for (i = 0; i < ARRAY_SIZE(scenario_default); i++) {
+			if (scenario_fork(&scenario_default[i], root)) {
+				fprintf(stderr, "%s: failed\n",
+					scenario_default[i].name);
+				ret = 1;
+			}
+		}
+	}
+
+	procgen_root_remove(root);
+
+	return ret;
+}
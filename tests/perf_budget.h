@@ -0,0 +1,83 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __perf_budget_h
+#define __perf_budget_h
+
+/*
+   Budgets of test_perf. The values are counts, not timings, so they are the
+   same on every machine; lower them together with changes which make the
+   refresh path cheaper.
+*/
+
+/** Synthetic table size */
+#define PERF_TABLE_ROWS 1000
+#define PERF_TABLE_COLS 8
+
+/** Keys of each kind pressed */
+#define PERF_KEYS 20
+
+/** linux_file_read: open, read, read at EOF, close */
+#define BUDGET_REFRESH_SYSCALLS 4
+
+/** ui_redraw: header and visible lines */
+#define BUDGET_FRAME_LINE_GET 39
+
+/** ui_redraw: bytes passed to addstr */
+#define BUDGET_FRAME_BYTES 3484
+
+/** ui_redraw: addstr, move and clrtoeol calls */
+#define BUDGET_FRAME_TERM_CALLS 122
+
+/** Navigation helpers and ui_redraw */
+#define BUDGET_NAV_LINE_GET 48
+
+/** Navigation helpers and ui_redraw with a filter matching 111 rows */
+#define BUDGET_FILTER_NAV_LINE_GET 444
+
+/** linux_text_parse: lines indexed for a filter matching 111 rows */
+#define BUDGET_FILTER_LINES 111
+
+/** top_search: pages scanned for a text none of them contains */
+#define BUDGET_SEARCH_SCANNED 0
+
+/** Shadow screen: cells sent for a refresh of an unchanged page */
+#define BUDGET_SCREEN_UNCHANGED_BYTES 0
+
+/** Shadow screen: a row sent on the last credit of the line rate */
+#define BUDGET_SCREEN_EXCESS_BYTES 132
+
+/** Main loop: initial frame and one frame for a burst of keys */
+#define BUDGET_BURST_FRAMES 2
+
+/** Terminal input: the burst and the end of input */
+#define BUDGET_BURST_READS 2
+
+/** ui_redraw: the row scrolled in and the footer */
+#define BUDGET_SCROLL_BYTES 189
+
+/** Switch to a prefetched page: restored from the snapshot cache */
+#define BUDGET_PREFETCH_FETCHES 0
+
+/** watch_get: open, read, close for the rows pinned on both pages of
+    the file */
+#define BUDGET_WATCH_SYSCALLS 3
+
+/** watch_get: the pinned pages aren't parsed */
+#define BUDGET_WATCH_LINE_GET 0
+
+/** top_batch: fetches of the pages not in the batch list */
+#define BUDGET_BATCH_UNLISTED_FETCHES 0
+
+/** table_write: line_get calls for each line of the table */
+#define BUDGET_WRITE_LINE_GET 1
+
+/** table_write: bytes of the text table */
+#define BUDGET_WRITE_BYTES 90101
+
+#endif
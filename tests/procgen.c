@@ -0,0 +1,129 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* nftw */
+#define _XOPEN_SOURCE 700
+
+#include "gpon_libs_config.h"
+#include "procgen.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+int procgen_root_create(char *root, size_t len)
+{
+	static const char * const dir[] = {
+		"driver", "driver/onu", "driver/optic"
+	};
+	char path[256];
+	unsigned int i;
+
+	if (snprintf(root, len, "/tmp/procgen.XXXXXX") >= (int)len)
+		return -1;
+
+	if (!mkdtemp(root))
+		return -1;
+
+	for (i = 0; i < sizeof(dir) / sizeof(dir[0]); i++) {
+		snprintf(path, sizeof(path), "%s/%s", root, dir[i]);
+		if (mkdir(path, 0755)) {
+			procgen_root_remove(root);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int entry_remove(const char *path, const struct stat *st, int flag,
+			struct FTW *ftw)
+{
+	return remove(path);
+}
+
+void procgen_root_remove(const char *root)
+{
+	(void)nftw(root, entry_remove, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+/** Counter value of a cell (xorshift of the cell position) */
+static unsigned int cell_value(unsigned int row, unsigned int col,
+			       unsigned int seed)
+{
+	unsigned int x = (row * 2654435761u) ^ (col * 40503u) ^ seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	return x;
+}
+
+int procgen_table(const char *root, const char *name, unsigned int rows,
+		  unsigned int cols, unsigned int seed)
+{
+	char path[256];
+	unsigned int row, col;
+	FILE *f;
+	int ret;
+
+	snprintf(path, sizeof(path), "%s/driver/onu/%s", root, name);
+
+	f = fopen(path, "w");
+	if (!f)
+		return -1;
+
+	fprintf(f, "%-12s", "name");
+	for (col = 1; col < cols; col++)
+		fprintf(f, " cnt%-7u", col);
+	fprintf(f, "\n");
+
+	for (row = 0; row < rows; row++) {
+		fprintf(f, "%s%-8u", "port", row);
+		for (col = 1; col < cols; col++)
+			fprintf(f, " %10u", cell_value(row, col, seed));
+		fprintf(f, "\n");
+	}
+
+	ret = ferror(f) ? -1 : 0;
+	if (fclose(f))
+		ret = -1;
+
+	return ret;
+}
+
+int procgen_hung(const char *root, const char *name)
+{
+	char path[256];
+
+	snprintf(path, sizeof(path), "%s/driver/onu/%s", root, name);
+
+	if (unlink(path) && errno != ENOENT)
+		return -1;
+
+	return mkfifo(path, 0600);
+}
+
+void procgen_release(const char *root, const char *name)
+{
+	char path[256];
+	int fd;
+
+	snprintf(path, sizeof(path), "%s/driver/onu/%s", root, name);
+
+	/* the blocked readers see the end of file */
+	fd = open(path, O_WRONLY | O_NONBLOCK);
+	if (fd >= 0)
+		close(fd);
+}
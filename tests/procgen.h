@@ -0,0 +1,55 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+#ifndef __procgen_h
+#define __procgen_h
+
+#include <stddef.h>
+
+/** Create temporary procfs root with empty driver/onu and driver/optic
+    directories
+
+   \param[out] root Path of the created directory
+   \param[in]  len  Size of root
+
+   \return 0 on success; -1 on error
+*/
+int procgen_root_create(char *root, size_t len);
+
+/** Remove procfs root and everything below it */
+void procgen_root_remove(const char *root);
+
+/** Write synthetic counter table to <root>/driver/onu/<name>
+
+   The table looks like the driver tables: a header line followed by
+   whitespace aligned rows of a name and (cols - 1) counters. The contents
+   only depend on the arguments; a different seed changes the counters but
+   not the layout.
+
+   \param[in] root Procfs root
+   \param[in] name Table name
+   \param[in] rows Number of data rows
+   \param[in] cols Number of columns (at least 1)
+   \param[in] seed Counter seed
+
+   \return 0 on success; -1 on error
+*/
+int procgen_table(const char *root, const char *name, unsigned int rows,
+		  unsigned int cols, unsigned int seed);
+
+/** Replace table with a FIFO; reading it blocks like a hung proc handler
+    until \ref procgen_release
+
+   \return 0 on success; -1 on error
+*/
+int procgen_hung(const char *root, const char *name);
+
+/** Let the reads blocked on a FIFO of \ref procgen_hung return */
+void procgen_release(const char *root, const char *name);
+
+#endif
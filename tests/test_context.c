@@ -0,0 +1,253 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* Several contexts driven by scripted key input on separate threads must
+   not see each other's state; signals must reach every attached context. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#define SESSION_NUM 8
+#define PAGE_NUM 3
+
+/** Group key 'g' followed by a page key has to select a page of group 'g';
+    interleaving with other sessions must not change that */
+static const char script[] = "gacgbcgagb";
+
+/** Page selected after each key of the script */
+static const unsigned int expect_sel[] = { 0, 0, 2, 2, 1, 2, 2, 0, 0, 1 };
+
+struct session {
+	unsigned int id;
+	char dir[64];
+	char file[PAGE_NUM][96];
+	struct top_page_desc page[PAGE_NUM];
+	struct top_context ctx;
+	unsigned int pos;
+	unsigned int sel[sizeof(script)];
+	unsigned int sel_num;
+	/** Own page was drawn */
+	int drawn;
+	int failed;
+};
+
+static struct session session[SESSION_NUM];
+
+static void fail(struct session *s, const char *what)
+{
+	fprintf(stderr, "session %u: %s\n", s->id, what);
+	s->failed = 1;
+}
+
+static void s_addstr(struct top_context *ctx, const char *str)
+{
+	struct session *s = ctx->priv;
+	const char *p = strstr(str, "session ");
+	unsigned int id;
+
+	if (p && sscanf(p, "session %u", &id) == 1) {
+		if (id != s->id)
+			fail(s, "page of another session shown");
+		else
+			s->drawn = 1;
+	}
+}
+
+static void s_nop(struct top_context *ctx)
+{
+}
+
+static void s_move(struct top_context *ctx, int y, int x)
+{
+}
+
+static int s_hasch(struct top_context *ctx)
+{
+	return 1;
+}
+
+static int s_getch(struct top_context *ctx)
+{
+	struct session *s = ctx->priv;
+
+	/* the previous key is processed now */
+	if (s->pos)
+		s->sel[s->sel_num++] = ctx->page_sel;
+
+	/* give the other sessions a chance to interleave */
+	usleep(200);
+
+	if (s->pos < sizeof(script) - 1)
+		return script[s->pos++];
+
+	return KEY_CTRL_C;
+}
+
+static void s_terminal_size_get(struct top_context *ctx)
+{
+	ctx->rows = 24;
+	ctx->cols = 80;
+}
+
+static const struct top_operations session_ops = {
+	.addstr = s_addstr,
+	.clrtoeol = s_nop,
+	.clear = s_nop,
+	.move = s_move,
+	.getch = s_getch,
+	.hasch = s_hasch,
+	.terminal_size_get = s_terminal_size_get,
+};
+
+static int page_get(struct top_context *ctx, const char *name)
+{
+	return linux_file_read(ctx, name);
+}
+
+static void *session_run(void *arg)
+{
+	struct session *s = arg;
+	unsigned int i;
+
+	top_ui_prepare(&s->ctx);
+	top_ui_main_loop(&s->ctx);
+	top_ui_shutdown(&s->ctx);
+
+	for (i = 0; i < s->sel_num && i < sizeof(expect_sel) /
+					    sizeof(expect_sel[0]); i++)
+		if (s->sel[i] != expect_sel[i])
+			fail(s, "wrong page selected");
+
+	if (!s->drawn)
+		fail(s, "page not drawn");
+
+	return NULL;
+}
+
+static int session_init(struct session *s, unsigned int id)
+{
+	static const int key[PAGE_NUM][2] = {
+		{ 'g', 'a' }, { 'g', 'b' }, { 0, 'c' }
+	};
+	unsigned int i;
+	FILE *f;
+
+	s->id = id;
+	snprintf(s->dir, sizeof(s->dir), "/tmp/test_context.XXXXXX");
+	if (!mkdtemp(s->dir))
+		return -1;
+
+	for (i = 0; i < PAGE_NUM; i++) {
+		snprintf(s->file[i], sizeof(s->file[i]), "%s/page%u", s->dir,
+			 i);
+		f = fopen(s->file[i], "w");
+		if (!f)
+			return -1;
+		fprintf(f, "session %u page %u\nrow 1\n", id, i);
+		fclose(f);
+
+		s->page[i].group_key = key[i][0];
+		s->page[i].key = key[i][1];
+		s->page[i].name = s->file[i] + strlen(s->dir) + 1;
+		s->page[i].line_get = top_proc_line_get;
+		s->page[i].page_get = page_get;
+		s->page[i].input_file_name = s->file[i];
+	}
+
+	return top_init(&s->ctx, &session_ops, -1, s->page, PAGE_NUM,
+			NULL, 0, 1, NULL, NULL, s);
+}
+
+static void session_free(struct session *s)
+{
+	unsigned int i;
+
+	top_shutdown(&s->ctx);
+
+	for (i = 0; i < PAGE_NUM; i++)
+		unlink(s->file[i]);
+	rmdir(s->dir);
+}
+
+/** Signals have to reach every attached context */
+static int signal_check(void)
+{
+	struct sigaction sa;
+	unsigned int i;
+	int ret = 0;
+
+	for (i = 0; i < SESSION_NUM; i++) {
+		session[i].ctx.need_shutdown = 0;
+		session[i].ctx.need_resize = 0;
+		if (top_signal_attach(&session[i].ctx))
+			ret = -1;
+	}
+
+	raise(SIGWINCH);
+	raise(SIGINT);
+
+	for (i = 0; i < SESSION_NUM; i++) {
+		if (!session[i].ctx.need_resize ||
+		    !session[i].ctx.need_shutdown) {
+			fail(&session[i], "signal not delivered");
+			ret = -1;
+		}
+		top_signal_detach(&session[i].ctx);
+	}
+
+	/* the default handler is back */
+	sigaction(SIGINT, NULL, &sa);
+	if (sa.sa_handler != SIG_DFL) {
+		fprintf(stderr, "SIGINT handler not restored\n");
+		ret = -1;
+	}
+
+	return ret;
+}
+
+int main(void)
+{
+	pthread_t thread[SESSION_NUM];
+	unsigned int i;
+	int ret = 0;
+
+	for (i = 0; i < SESSION_NUM; i++) {
+		if (session_init(&session[i], i)) {
+			fprintf(stderr, "session %u: init failed\n", i);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < SESSION_NUM; i++)
+		if (pthread_create(&thread[i], NULL, session_run,
+				   &session[i]))
+			return 1;
+
+	for (i = 0; i < SESSION_NUM; i++) {
+		pthread_join(thread[i], NULL);
+		if (session[i].failed)
+			ret = 1;
+		if (session[i].sel_num != sizeof(script) - 1) {
+			fail(&session[i], "script not processed");
+			ret = 1;
+		}
+	}
+
+	if (signal_check())
+		ret = 1;
+
+	for (i = 0; i < SESSION_NUM; i++)
+		session_free(&session[i]);
+
+	return ret;
+}
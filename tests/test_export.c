@@ -0,0 +1,163 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* A page is exported as CSV, NDJSON and JSON: the column schema and types
+   are detected from the header and the cells, CSV fields with separators,
+   quotes or line breaks are quoted, empty and non-finite cells stay valid
+   JSON. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "top_table.h"
+
+/** Lines of the page; the first one is the header */
+static const char * const table[] = {
+	"name;count;ratio;note",
+	"a,b;1;0.5;say \"hi\"",
+	"c;-2;;x",
+	"e\nf;0x10;1e999;",
+	"g;4;2.5;z"
+};
+
+static const char * const csv =
+	"page,name,count,ratio,note" TOP_CRLF
+	"export,\"a,b\",1,0.5,\"say \"\"hi\"\"\"" TOP_CRLF
+	"export,c,-2,,x" TOP_CRLF
+	"export,\"e\nf\",0x10,1e999," TOP_CRLF
+	"export,g,4,2.5,z" TOP_CRLF;
+
+static const char * const ndjson =
+	"{\"page\":\"export\",\"name\":\"a,b\",\"count\":1,\"ratio\":0.5,"
+	"\"note\":\"say \\\"hi\\\"\"}" TOP_CRLF
+	"{\"page\":\"export\",\"name\":\"c\",\"count\":-2,\"ratio\":null,"
+	"\"note\":\"x\"}" TOP_CRLF
+	"{\"page\":\"export\",\"name\":\"e\\u000af\",\"count\":16,"
+	"\"ratio\":\"1e999\",\"note\":null}" TOP_CRLF
+	"{\"page\":\"export\",\"name\":\"g\",\"count\":4,\"ratio\":2.5,"
+	"\"note\":\"z\"}" TOP_CRLF;
+
+static const char * const json =
+	"{\"page\":\"export\",\"columns\":["
+	"{\"name\":\"name\",\"type\":\"string\"},"
+	"{\"name\":\"count\",\"type\":\"integer\"},"
+	"{\"name\":\"ratio\",\"type\":\"number\"},"
+	"{\"name\":\"note\",\"type\":\"string\"}],\"rows\":["
+	"[\"a,b\",1,0.5,\"say \\\"hi\\\"\"],"
+	"[\"c\",-2,null,\"x\"],"
+	"[\"e\\u000af\",16,\"1e999\",null],"
+	"[\"g\",4,2.5,\"z\"]]}" TOP_CRLF;
+
+static int table_get(struct top_context *ctx, const char *name)
+{
+	return ARRAY_SIZE(table);
+}
+
+static char *table_line_get(struct top_context *ctx, const int line,
+			    char *text)
+{
+	if (line < 0 || line >= (int)ARRAY_SIZE(table))
+		return NULL;
+
+	return (char *)table[line];
+}
+
+static const char *schema_line_get(void *arg, int line, char *buff)
+{
+	return table_line_get(NULL, line, buff);
+}
+
+static const struct top_page_desc page[] = {
+	CNT(0, 'e', "export", table_line_get, table_get, NULL, NULL)
+};
+
+static struct top_record rec;
+static int failed;
+
+static void check(bool ok, const char *what)
+{
+	if (ok)
+		return;
+
+	fprintf(stderr, "%s\n", what);
+	failed = 1;
+}
+
+static void schema_check(void)
+{
+	static const enum top_cell_type type[] = {
+		TOP_CELL_STRING, TOP_CELL_INT, TOP_CELL_FLOAT, TOP_CELL_STRING
+	};
+	static const char * const name[] = { "name", "count", "ratio", "note" };
+	struct top_schema schema;
+	unsigned int k;
+
+	top_schema_detect(&schema, schema_line_get, NULL, ARRAY_SIZE(table));
+
+	check(schema.sep == ';' && schema.first == 1 &&
+	      schema.cols == (int)ARRAY_SIZE(name), "wrong table layout");
+
+	for (k = 0; k < ARRAY_SIZE(name) && k < (unsigned int)schema.cols;
+	     k++) {
+		if (strcmp(schema.name[k], name[k]) == 0 &&
+		    schema.type[k] == type[k])
+			continue;
+
+		fprintf(stderr, "column %u: %s, type %d\n", k, schema.name[k],
+			schema.type[k]);
+		failed = 1;
+	}
+}
+
+static void export_check(struct top_context *ctx, enum top_format format,
+			 const char *expect, const char *what)
+{
+	char *text = NULL;
+	size_t len = 0;
+	FILE *f;
+
+	f = open_memstream(&text, &len);
+	if (!f) {
+		check(false, "can't open the export stream");
+		return;
+	}
+
+	top_write_format_set(ctx, format);
+	table_export(ctx, f, 0);
+	fclose(f);
+
+	if (strcmp(text, expect)) {
+		fprintf(stderr, "%s export:\n%s\nexpected:\n%s\n", what, text,
+			expect);
+		failed = 1;
+	}
+
+	free(text);
+}
+
+int main(void)
+{
+	static struct top_context ctx;
+
+	schema_check();
+
+	if (top_init(&ctx, &record_top_ops, -1, page, ARRAY_SIZE(page), NULL,
+		     0, 100, NULL, NULL, &rec))
+		return 1;
+
+	check(counters_fetch(&ctx, 0) == (int)ARRAY_SIZE(table),
+	      "page not fetched");
+
+	export_check(&ctx, TOP_FORMAT_CSV, csv, "CSV");
+	export_check(&ctx, TOP_FORMAT_NDJSON, ndjson, "NDJSON");
+	export_check(&ctx, TOP_FORMAT_JSON, json, "JSON");
+
+	top_shutdown(&ctx);
+
+	return failed;
+}
@@ -0,0 +1,205 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* A page file whose read never returns (a FIFO stands in for a wedged proc
+   handler) must not block the fetch beyond its deadline; the page keeps its
+   last data and is marked stale, other pages are fetched as usual. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "procgen.h"
+
+#include <unistd.h>
+
+/** Read deadline and update interval (in ms) */
+#define FETCH_TIMEOUT 100
+#define FETCH_INTERVAL 100
+
+/** Upper limit (in ms) of a fetch of a hung page */
+#define FETCH_TIME_MAX 1000
+
+/** Rows of the generated tables */
+#define FETCH_ROWS 10
+
+static const struct top_page_desc page[] = {
+	{ 0, 'g', "good", top_proc_line_get, onu_top_proc_get, NULL, NULL,
+	  "good", NULL, 0 },
+	{ 0, 'h', "hung", top_proc_line_get, onu_top_proc_get, NULL, NULL,
+	  "hung", NULL, 0 },
+	{ 0, 'f', "flaky", top_proc_line_get, onu_top_proc_get, NULL, NULL,
+	  "flaky", NULL, 0 }
+};
+
+enum {
+	PAGE_GOOD,
+	PAGE_HUNG,
+	PAGE_FLAKY
+};
+
+static struct top_record rec;
+static int failed;
+
+static void check(bool ok, const char *what)
+{
+	if (ok)
+		return;
+
+	fprintf(stderr, "%s\n", what);
+	failed = 1;
+}
+
+/** Fetch page
+
+   \param[out] ms Duration of the fetch (in ms)
+
+   \return Number of lines
+*/
+static int fetch(struct top_context *ctx, unsigned int page_idx,
+		 uint64_t *ms)
+{
+	uint64_t start = top_time_ms();
+	int total;
+
+	total = counters_fetch(ctx, page_idx);
+	*ms = top_time_ms() - start;
+
+	return total;
+}
+
+static void status_check(struct top_context *ctx, unsigned int page_idx,
+			 const char *expect, const char *what)
+{
+	char status[64];
+
+	check(fetch_status_get(ctx, page_idx, status, sizeof(status)) &&
+	      strstr(status, expect), what);
+}
+
+static void hung_check(struct top_context *ctx)
+{
+	uint64_t ms;
+	int total;
+
+	total = fetch(ctx, PAGE_HUNG, &ms);
+	check(ms >= FETCH_TIMEOUT && ms < FETCH_TIME_MAX,
+	      "hung fetch not cut off at the deadline");
+	check(total == 0, "hung page has lines");
+	check(ctx->page_state[PAGE_HUNG].stale, "hung page not stale");
+	status_check(ctx, PAGE_HUNG, "No data", "hung page status");
+
+	/* the wait isn't taken as the fetch time, the backoff starts at one
+	   interval */
+	check(top_page_interval_get(ctx, PAGE_HUNG) == FETCH_INTERVAL,
+	      "hung page interval raised");
+	check(ctx->page_state[PAGE_HUNG].backoff <=
+	      top_time_ms() + FETCH_INTERVAL, "first backoff too long");
+	check(snapshot_cache_update(ctx, PAGE_HUNG) < 0,
+	      "hung page cached");
+
+	/* the read is still pending, no new one is started */
+	total = fetch(ctx, PAGE_HUNG, &ms);
+	check(ms < FETCH_TIMEOUT, "blocked page waits for the deadline");
+	check(total == 0, "blocked page has lines");
+
+	total = fetch(ctx, PAGE_GOOD, &ms);
+	check(total == FETCH_ROWS + 1, "good page not fetched");
+	check(!ctx->page_state[PAGE_GOOD].stale, "good page stale");
+}
+
+static void flaky_check(struct top_context *ctx, const char *root)
+{
+	const struct top_snapshot *snap;
+	char text[TOP_LINE_LEN];
+	const char *line;
+	uint64_t ms, stamp;
+	int total;
+
+	total = fetch(ctx, PAGE_FLAKY, &ms);
+	check(total == FETCH_ROWS + 1, "flaky page not fetched");
+	check(snapshot_cache_update(ctx, PAGE_FLAKY) == 0,
+	      "flaky page not cached");
+	snap = snapshot_cache_peek(ctx, PAGE_FLAKY);
+	stamp = snap ? snap->stamp : 0;
+	usleep(2000);
+
+	if (procgen_hung(root, page[PAGE_FLAKY].input_file_name)) {
+		check(false, "can't create FIFO");
+		return;
+	}
+
+	/* the last data is kept */
+	total = fetch(ctx, PAGE_FLAKY, &ms);
+	check(total == FETCH_ROWS + 1, "stale page lost its lines");
+	line = top_proc_line_get(ctx, 1, text);
+	check(line && strstr(line, "port"), "stale page lost its text");
+	status_check(ctx, PAGE_FLAKY, "Stale since", "flaky page status");
+	check(top_page_interval_get(ctx, PAGE_FLAKY) == FETCH_INTERVAL,
+	      "stale page interval raised");
+
+	/* the cached snapshot keeps the time of the last fetch in time */
+	check(snapshot_cache_update(ctx, PAGE_FLAKY) == 0 &&
+	      snap && snap->stamp == stamp, "stale page cached as fresh");
+
+	/* the page times out again after the backoff */
+	procgen_release(root, page[PAGE_FLAKY].input_file_name);
+	usleep(4 * top_page_interval_get(ctx, PAGE_FLAKY) * 1000);
+	total = fetch(ctx, PAGE_FLAKY, &ms);
+	check(ctx->page_state[PAGE_FLAKY].timeouts == 2,
+	      "repeated timeout not counted");
+	check(ctx->page_state[PAGE_FLAKY].backoff >
+	      top_time_ms() + top_page_interval_get(ctx, PAGE_FLAKY),
+	      "no backoff after repeated timeout");
+}
+
+int main(void)
+{
+	struct top_context *ctx;
+	char root[64];
+	unsigned int i;
+
+	if (procgen_root_create(root, sizeof(root)))
+		return 1;
+
+	for (i = 0; i < ARRAY_SIZE(page); i++) {
+		if (procgen_table(root, page[i].input_file_name, FETCH_ROWS, 4,
+				  i)) {
+			procgen_root_remove(root);
+			return 1;
+		}
+	}
+
+	if (procgen_hung(root, page[PAGE_HUNG].input_file_name)) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	ctx = malloc(sizeof(*ctx));
+	if (!ctx || top_init(ctx, &record_top_ops, -1, page, ARRAY_SIZE(page),
+			     NULL, 0, FETCH_INTERVAL, NULL, NULL, &rec) ||
+	    top_proc_root_set(ctx, root)) {
+		free(ctx);
+		procgen_root_remove(root);
+		return 1;
+	}
+	top_fetch_timeout_set(ctx, FETCH_TIMEOUT);
+	top_record_init(&rec, 24, 80);
+
+	hung_check(ctx);
+	flaky_check(ctx, root);
+
+	/* let the left behind reads return */
+	procgen_release(root, page[PAGE_HUNG].input_file_name);
+	procgen_release(root, page[PAGE_FLAKY].input_file_name);
+
+	top_shutdown(ctx);
+	free(ctx);
+	procgen_root_remove(root);
+
+	return failed;
+}
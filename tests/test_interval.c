@@ -0,0 +1,185 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* Update intervals follow the page contents: an unchanged page backs off up
+   to TOP_INTERVAL_MAX, a changed one returns towards the configured
+   interval; a fixed interval doesn't adapt and a slow fetch stretches the
+   interval to keep its share of the time. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "procgen.h"
+
+#include <unistd.h>
+
+/** Configured and fixed update interval (in ms) */
+#define INTERVAL_BASE 100
+#define INTERVAL_FIXED 700
+
+/** Duration (in ms) of a fetch of the slow page */
+#define INTERVAL_SLOW 20
+
+/** Share (in %) of the interval the slow page may take */
+#define INTERVAL_SHARE 1
+
+/** Rows and columns of the generated tables */
+#define INTERVAL_ROWS 10
+#define INTERVAL_COLS 4
+
+static int slow_get(struct top_context *ctx, const char *name);
+
+static const struct top_page_desc page[] = {
+	ONU_CNT_PROC(0, 'a', "adaptive", "adaptive")
+	{ 0, 'f', "fixed", top_proc_line_get, onu_top_proc_get, NULL, NULL,
+	  "fixed", NULL, INTERVAL_FIXED },
+	{ 0, 's', "slow", top_proc_line_get, slow_get, NULL, NULL,
+	  "slow", NULL, 0 }
+};
+
+enum {
+	PAGE_ADAPTIVE,
+	PAGE_FIXED,
+	PAGE_SLOW
+};
+
+static struct top_record rec;
+static int failed;
+
+static void check(bool ok, const char *what)
+{
+	if (ok)
+		return;
+
+	fprintf(stderr, "%s\n", what);
+	failed = 1;
+}
+
+static int slow_get(struct top_context *ctx, const char *name)
+{
+	usleep(INTERVAL_SLOW * 1000);
+
+	return onu_top_proc_get(ctx, name);
+}
+
+/** Fetch page, changing its contents first if seed isn't 0
+
+   \return Update interval (in ms) after the fetch
+*/
+static unsigned int fetch(struct top_context *ctx, const char *root,
+			  unsigned int page_idx, unsigned int seed)
+{
+	if (seed && procgen_table(root, page[page_idx].input_file_name,
+				  INTERVAL_ROWS, INTERVAL_COLS, seed))
+		check(false, "can't change the table");
+
+	(void)counters_fetch(ctx, page_idx);
+
+	return top_page_interval_get(ctx, page_idx);
+}
+
+static void adaptive_check(struct top_context *ctx, const char *root)
+{
+	unsigned int expect = INTERVAL_BASE;
+	unsigned int seed = 1;
+
+	/* the first fetch is a change */
+	check(fetch(ctx, root, PAGE_ADAPTIVE, 0) == INTERVAL_BASE,
+	      "first interval isn't the configured one");
+
+	do {
+		expect = expect * 2 < TOP_INTERVAL_MAX ? expect * 2 :
+							 TOP_INTERVAL_MAX;
+		if (fetch(ctx, root, PAGE_ADAPTIVE, 0) != expect) {
+			check(false, "unchanged page doesn't back off");
+			return;
+		}
+	} while (expect < TOP_INTERVAL_MAX);
+
+	check(fetch(ctx, root, PAGE_ADAPTIVE, 0) == TOP_INTERVAL_MAX,
+	      "back-off beyond TOP_INTERVAL_MAX");
+
+	do {
+		expect = expect / 2 > INTERVAL_BASE ? expect / 2 :
+						      INTERVAL_BASE;
+		if (fetch(ctx, root, PAGE_ADAPTIVE, seed++) != expect) {
+			check(false, "changed page doesn't halve the interval");
+			return;
+		}
+	} while (expect > INTERVAL_BASE);
+
+	check(fetch(ctx, root, PAGE_ADAPTIVE, seed) == INTERVAL_BASE,
+	      "interval below the configured one");
+}
+
+static void fixed_check(struct top_context *ctx, const char *root)
+{
+	unsigned int i;
+
+	for (i = 0; i < 3; i++)
+		check(fetch(ctx, root, PAGE_FIXED, 0) == INTERVAL_FIXED,
+		      "fixed interval of an unchanged page adapted");
+
+	check(fetch(ctx, root, PAGE_FIXED, 1) == INTERVAL_FIXED,
+	      "fixed interval of a changed page adapted");
+}
+
+static void share_check(struct top_context *ctx, const char *root)
+{
+	/* us / (10 * percent) */
+	unsigned int min = INTERVAL_SLOW * 100 / INTERVAL_SHARE;
+
+	check(fetch(ctx, root, PAGE_SLOW, 0) == INTERVAL_BASE,
+	      "slow page stretched without a share limit");
+
+	/* learned intervals start over */
+	top_upd_delay_set(ctx, INTERVAL_BASE);
+	top_fetch_share_set(ctx, INTERVAL_SHARE);
+
+	check(fetch(ctx, root, PAGE_SLOW, 0) >= min,
+	      "slow page exceeds its share");
+	check(fetch(ctx, root, PAGE_ADAPTIVE, 1) == INTERVAL_BASE,
+	      "fast page stretched by the share limit");
+}
+
+int main(void)
+{
+	static struct top_context ctx;
+	char root[64];
+	unsigned int i;
+
+	if (procgen_root_create(root, sizeof(root)))
+		return 1;
+
+	for (i = 0; i < ARRAY_SIZE(page); i++) {
+		if (procgen_table(root, page[i].input_file_name,
+				  INTERVAL_ROWS, INTERVAL_COLS, 0)) {
+			procgen_root_remove(root);
+			return 1;
+		}
+	}
+
+	if (top_init(&ctx, &record_top_ops, -1, page, ARRAY_SIZE(page), NULL,
+		     0, INTERVAL_BASE, NULL, NULL, &rec) ||
+	    top_proc_root_set(&ctx, root)) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	/* the fetch time of the fast pages mustn't count */
+	top_fetch_share_set(&ctx, 0);
+
+	adaptive_check(&ctx, root);
+	fixed_check(&ctx, root);
+	share_check(&ctx, root);
+
+	top_shutdown(&ctx);
+	procgen_root_remove(root);
+
+	return failed;
+}
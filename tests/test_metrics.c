@@ -0,0 +1,246 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* The metrics endpoint is scraped over localhost while the server loop
+   runs in a thread; an idle scraper connected first must not hold up the
+   scrape. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "procgen.h"
+
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/** Rows and columns of the generated table */
+#define METRICS_ROWS 10
+#define METRICS_COLS 4
+
+/** Row and column checked in the scrape */
+#define METRICS_ROW 7
+#define METRICS_COL 2
+
+/** Number of scrapes (10 ms apart) waiting for the first rendering */
+#define METRICS_WAIT 100
+
+/** Upper limit (in ms) of a scrape next to an idle scraper */
+#define METRICS_SCRAPE_MAX (TOP_METRICS_TIMEOUT / 2)
+
+static const struct top_page_desc page[] = {
+	ONU_CNT_PROC(0, 'm', "Metrics Page", "metrics")
+};
+
+static struct top_record rec;
+static int failed;
+
+static void check(bool ok, const char *what)
+{
+	if (ok)
+		return;
+
+	fprintf(stderr, "%s\n", what);
+	failed = 1;
+}
+
+static void *server_thread(void *arg)
+{
+	struct top_context *ctx = arg;
+
+	if (top_server_run(ctx, NULL))
+		check(false, "server not started");
+
+	return NULL;
+}
+
+/** Connect to the metrics endpoint
+
+   \return Socket; -1 on error
+*/
+static int metrics_connect(const struct sockaddr_in *sa)
+{
+	int fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+
+	if (connect(fd, (const struct sockaddr *)sa, sizeof(*sa))) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+/** Scrape /metrics
+
+   \param[out] reply Reply, NUL terminated
+   \param[in]  size  Size of reply
+
+   \return Length of the reply; -1 on error
+*/
+static int scrape(const struct sockaddr_in *sa, const char *request,
+		  char *reply, size_t size)
+{
+	size_t len = 0;
+	ssize_t n;
+	int fd;
+
+	fd = metrics_connect(sa);
+	if (fd < 0)
+		return -1;
+
+	if (send(fd, request, strlen(request), MSG_NOSIGNAL) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	while (len < size - 1) {
+		n = recv(fd, reply + len, size - 1 - len, 0);
+		if (n <= 0)
+			break;
+		len += n;
+	}
+	reply[len] = 0;
+	close(fd);
+
+	return (int)len;
+}
+
+/** Build the sample expected for a cell of the generated table */
+static int sample_expect(const char *root, char *sample, size_t size)
+{
+	char path[256], line[TOP_LINE_LEN];
+	char row[32], value[32];
+	unsigned int i;
+	FILE *f;
+
+	snprintf(path, sizeof(path), "%s/driver/onu/%s", root,
+		 page[0].input_file_name);
+	f = fopen(path, "r");
+	if (!f)
+		return -1;
+
+	/* header and rows before the checked one */
+	for (i = 0; i <= METRICS_ROW + 1; i++)
+		if (!fgets(line, sizeof(line), f))
+			break;
+	fclose(f);
+
+	if (i <= METRICS_ROW + 1 ||
+	    sscanf(line, "%31s %*s %31s", row, value) != 2)
+		return -1;
+
+	snprintf(sample, size, TOP_METRICS_PREFIX "metrics_page_cnt%u"
+		 "{page=\"Metrics Page\",row=\"%s\"} %s\n", METRICS_COL, row,
+		 value);
+
+	return 0;
+}
+
+static void scrape_check(struct top_context *ctx, const char *root)
+{
+	static char reply[65536];
+	struct sockaddr_in sa;
+	socklen_t len = sizeof(sa);
+	char sample[TOP_LINE_LEN];
+	uint64_t start;
+	unsigned int i;
+	int idle, n;
+
+	if (getsockname(metrics_fd_get(ctx), (struct sockaddr *)&sa, &len) ||
+	    sample_expect(root, sample, sizeof(sample))) {
+		check(false, "can't set up the scrape");
+		return;
+	}
+
+	/* the pages are rendered on the first pass of the server loop */
+	for (i = 0; i < METRICS_WAIT; i++) {
+		n = scrape(&sa, "GET /metrics HTTP/1.0\r\n\r\n", reply,
+			   sizeof(reply));
+		if (n > 0 && strstr(reply, "# TYPE "))
+			break;
+		usleep(10 * 1000);
+	}
+
+	/* connected, but never sends a request */
+	idle = metrics_connect(&sa);
+	check(idle >= 0, "idle scraper can't connect");
+
+	start = top_time_ms();
+	n = scrape(&sa, "GET /metrics HTTP/1.0\r\n"
+		   "Accept: application/openmetrics-text\r\n\r\n",
+		   reply, sizeof(reply));
+	check(top_time_ms() - start < METRICS_SCRAPE_MAX,
+	      "scrape held up by the idle scraper");
+
+	check(n > 0 && strncmp(reply, "HTTP/1.0 200 OK\r\n", 17) == 0,
+	      "scrape failed");
+	check(strstr(reply, "application/openmetrics-text") != NULL,
+	      "no OpenMetrics content type");
+	check(strstr(reply, "# TYPE " TOP_METRICS_PREFIX
+		     "metrics_page_cnt1 gauge\n") != NULL, "no metric family");
+	check(strstr(reply, sample) != NULL, "sample missing");
+	check(n > 6 && strcmp(reply + n - 6, "# EOF\n") == 0, "no EOF marker");
+
+	n = scrape(&sa, "GET /other HTTP/1.0\r\n\r\n", reply, sizeof(reply));
+	check(n > 0 && strstr(reply, " 404 ") != NULL, "no 404 reply");
+
+	if (idle >= 0)
+		close(idle);
+}
+
+int main(void)
+{
+	struct top_context *ctx;
+	pthread_t thread;
+	char root[64];
+
+	if (procgen_root_create(root, sizeof(root)))
+		return 1;
+
+	if (procgen_table(root, page[0].input_file_name, METRICS_ROWS,
+			  METRICS_COLS, 0)) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	ctx = malloc(sizeof(*ctx));
+	if (!ctx || top_init(ctx, &record_top_ops, -1, page, ARRAY_SIZE(page),
+			     NULL, 0, 100, NULL, NULL, &rec) ||
+	    top_proc_root_set(ctx, root)) {
+		free(ctx);
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	/* any free port */
+	if (top_metrics_init(ctx, TOP_METRICS_ADDR_DEFAULT, 0) ||
+	    top_metrics_page_add(ctx, 0) ||
+	    pthread_create(&thread, NULL, server_thread, ctx)) {
+		top_shutdown(ctx);
+		free(ctx);
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	scrape_check(ctx, root);
+
+	top_ui_stop(ctx);
+	pthread_join(thread, NULL);
+
+	top_shutdown(ctx);
+	free(ctx);
+	procgen_root_remove(root);
+
+	return failed;
+}
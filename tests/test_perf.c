@@ -0,0 +1,741 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* Deterministic costs of the refresh path (syscalls, line_get calls and
+   output bytes) must stay within the budgets of perf_budget.h. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "procgen.h"
+#include "perf_budget.h"
+
+#include <unistd.h>
+
+/** Terminal size */
+#define PERF_ROWS 40
+#define PERF_COLS 132
+
+/** Key sequences */
+#define PERF_KEY_NPAGE "\033[6~"
+#define PERF_KEY_PPAGE "\033[5~"
+#define PERF_KEY_HOME "\033[1~"
+#define PERF_KEY_END "\033[4~"
+#define PERF_KEY_DOWN "\033[B"
+#define PERF_KEY_UP "\033[A"
+
+/** Arrow down as sent in application cursor mode and with Ctrl held */
+#define PERF_KEY_DOWN_SS3 "\033OB"
+#define PERF_KEY_DOWN_CTRL "\033[1;5B"
+
+/** Filter pasted into the prompt and the line of the row matching it
+    3 * PERF_KEYS rows down ("port148") */
+#define PERF_PASTE "/" PERF_FILTER "\n"
+#define PERF_PASTE_LINE 150
+
+/** Upper limit of the prefetch steps waiting for the time budget */
+#define PERF_PREFETCH_STEPS 1000000
+
+/** Filter matching 111 of the 1000 rows */
+#define PERF_FILTER "port1"
+
+/** Filter prompt input widening PERF_FILTER to all rows */
+#define PERF_FILTER_WIDEN "/\b\n"
+
+/** Text of the last table row and search picking its first match */
+#define PERF_SEARCH "port999"
+#define PERF_SEARCH_KEYS "\006" PERF_SEARCH "\n\n"
+
+/** Dump of the selected page and the time (in ms) waited for the dump
+    writer */
+#define PERF_KEY_DUMP "\027"
+#define PERF_DUMP_WAIT_MS 5000
+
+/** Split the screen, focus the next pane; terminal rows for two panes */
+#define PERF_KEY_SPLIT "\026"
+#define PERF_KEY_PANE "\t"
+#define PERF_SPLIT_ROWS 8
+
+/** Batch list and its samples */
+#define PERF_BATCH_PAGES "b,perf"
+#define PERF_BATCH_COUNT 2
+#define PERF_BATCH_INTERVAL 10
+
+/** Text of none of the pages */
+#define PERF_SEARCH_ABSENT "gem 4095"
+
+/** Line rates (in bit/s) of a console keeping up with every frame and of a
+    slow serial console */
+#define PERF_LINE_RATE_FAST 100000000
+#define PERF_LINE_RATE_SLOW 9600
+
+static uint64_t line_get_calls;
+
+static char *counted_line_get(struct top_context *ctx, const int line,
+			      char *text)
+{
+	line_get_calls++;
+
+	return top_proc_line_get(ctx, line, text);
+}
+
+static const struct top_page_desc page[] = {
+	{ 0, 'a', "perf", counted_line_get, onu_top_proc_get, NULL, NULL,
+	  "perf", NULL, 0 },
+	/* same file as "perf" */
+	{ 0, 'b', "perf copy", top_proc_line_get, onu_top_proc_get, NULL, NULL,
+	  "perf", NULL, 0 },
+	CNT_WATCH(0, 'w', "watch")
+};
+
+/** Index of the watch page */
+#define PERF_PAGE_WATCH 2
+
+/** Rows pinned to the watch page */
+static const char * const watch_pin[] = {
+	"a:port1", "a:port500", "b:port999"
+};
+
+/** Pages written by the batch samples */
+static const char * const batch_page[] = {
+	"Page: perf copy", "Page: perf", "Page: perf copy", "Page: perf"
+};
+
+static struct top_record rec;
+static int failed;
+
+static void budget_check(const char *what, uint64_t value, uint64_t budget)
+{
+	printf("%-32s %8llu (budget %llu)\n", what,
+	       (unsigned long long)value, (unsigned long long)budget);
+
+	if (value > budget) {
+		fprintf(stderr, "%s: over budget\n", what);
+		failed = 1;
+	}
+}
+
+/** Append key sequence num times
+
+   \return num
+*/
+static unsigned int keys_add(char *keys, size_t size, const char *key,
+			     unsigned int num)
+{
+	unsigned int i;
+
+	for (i = 0; i < num; i++)
+		strncat(keys, key, size - strlen(keys) - 1);
+
+	return num;
+}
+
+/** Run the main loop from the top of the page
+
+   \return line_get calls of the keys (without the initial frame)
+*/
+static uint64_t keys_run(struct top_context *ctx, const char *keys)
+{
+	uint64_t calls;
+
+	/* initial frame only */
+	ctx->page_state[0].start = 0;
+	top_record_keys(&rec, "", 0);
+	line_get_calls = 0;
+	top_ui_main_loop(ctx);
+	calls = line_get_calls;
+
+	ctx->page_state[0].start = 0;
+	top_record_keys(&rec, keys, strlen(keys));
+	line_get_calls = 0;
+	top_ui_main_loop(ctx);
+
+	return line_get_calls - calls;
+}
+
+static void refresh_check(struct top_context *ctx)
+{
+	const struct top_prof_page *pp = &ctx->prof.page[0];
+	char keys[PERF_KEYS + 1];
+
+	top_prof_reset(ctx);
+	top_record_reset(&rec);
+	line_get_calls = 0;
+
+	/* every page key press fetches and redraws the page */
+	keys[0] = 0;
+	keys_add(keys, sizeof(keys), "a", PERF_KEYS);
+	top_record_keys(&rec, keys, strlen(keys));
+	top_ui_main_loop(ctx);
+
+	budget_check("syscalls per refresh", pp->syscalls / pp->fetches,
+		     BUDGET_REFRESH_SYSCALLS);
+	budget_check("line_get calls per frame", line_get_calls / rec.frames,
+		     BUDGET_FRAME_LINE_GET);
+	budget_check("bytes per frame", rec.bytes / rec.frames,
+		     BUDGET_FRAME_BYTES);
+	budget_check("terminal calls per frame",
+		     (rec.calls[TOP_RECORD_ADDSTR] +
+		      rec.calls[TOP_RECORD_MOVE] +
+		      rec.calls[TOP_RECORD_CLRTOEOL]) / rec.frames,
+		     BUDGET_FRAME_TERM_CALLS);
+}
+
+static void nav_check(struct top_context *ctx, const char *what,
+		      uint64_t budget)
+{
+	char keys[PERF_KEYS * 8 + 64];
+	unsigned int num = 0;
+
+	/* down and up the page, to the end and back, single lines */
+	keys[0] = 0;
+	num += keys_add(keys, sizeof(keys), PERF_KEY_NPAGE, PERF_KEYS);
+	num += keys_add(keys, sizeof(keys), PERF_KEY_PPAGE, PERF_KEYS);
+	num += keys_add(keys, sizeof(keys), PERF_KEY_END, 1);
+	num += keys_add(keys, sizeof(keys), PERF_KEY_HOME, 1);
+	num += keys_add(keys, sizeof(keys), PERF_KEY_DOWN, PERF_KEYS);
+	num += keys_add(keys, sizeof(keys), PERF_KEY_UP, PERF_KEYS);
+
+	budget_check(what, keys_run(ctx, keys) / num, budget);
+}
+
+static void prefetch_check(struct top_context *ctx)
+{
+	const struct top_prof_page *pp = &ctx->prof.page[1];
+	unsigned int i;
+
+	/* "perf copy" is next to the selected page */
+	top_select_group(ctx, page[PERF_PAGE_WATCH].name);
+
+	/* the recording backend never idles, step until the time allows */
+	top_prefetch_share_set(ctx, 100);
+	for (i = 0; i < PERF_PREFETCH_STEPS && !ctx->prefetch.fetches; i++)
+		prefetch_step(ctx);
+
+	/* the selected page wasn't fetched, it mustn't look fresh */
+	if (snapshot_cache_peek(ctx, ctx->page_sel)) {
+		fprintf(stderr, "prefetch cached the selected page\n");
+		failed = 1;
+	}
+
+	top_prof_reset(ctx);
+	top_record_keys(&rec, "b", 1);
+	top_ui_main_loop(ctx);
+
+	if (ctx->page_state[1].total != ctx->page_state[0].total) {
+		fprintf(stderr, "prefetched page: %d lines\n",
+			ctx->page_state[1].total);
+		failed = 1;
+	}
+
+	budget_check("fetches of a prefetched page", pp->fetches,
+		     BUDGET_PREFETCH_FETCHES);
+}
+
+/** Wait for the dump writer and count the lines of the dump written
+
+   \return Number of lines; -1 if no dump was written
+*/
+static int dump_lines(struct top_context *ctx)
+{
+	char status[TOP_LINE_LEN], path[TOP_LINE_LEN];
+	char line[TOP_LINE_LEN];
+	unsigned int i;
+	int lines = 0;
+	FILE *f;
+
+	status[0] = 0;
+	for (i = 0; i < PERF_DUMP_WAIT_MS; i++) {
+		if (writer_status_get(ctx, status, sizeof(status)))
+			break;
+		usleep(1000);
+	}
+
+	if (sscanf(status, "Saved to '%[^']'", path) != 1)
+		return -1;
+
+	f = fopen(path, "r");
+	if (!f)
+		return -1;
+
+	while (fgets(line, sizeof(line), f))
+		lines++;
+	fclose(f);
+
+	return lines;
+}
+
+static void filter_check(struct top_context *ctx)
+{
+	const struct top_page_state *state = &ctx->page_state[1];
+	char text[TOP_LINE_LEN];
+	const char *line;
+	int lines, total;
+
+	/* "perf copy" is selected and reads the lines from the line cache */
+	strcpy(ctx->filter, PERF_FILTER);
+	top_record_keys(&rec, "b", 1);
+	top_ui_main_loop(ctx);
+
+	line = top_proc_line_get(ctx, state->total - 1, text);
+	if (!line || !strstr(line, PERF_FILTER)) {
+		fprintf(stderr, "filtered page: last line \"%s\"\n",
+			line ? line : "");
+		failed = 1;
+	}
+
+	budget_check("lines indexed for a filter", state->total,
+		     BUDGET_FILTER_LINES);
+
+	/* the dump holds the lines the filter left out: the page name, the
+	 * header and all rows */
+	total = state->total;
+	top_record_keys(&rec, PERF_KEY_DUMP, strlen(PERF_KEY_DUMP));
+	top_ui_main_loop(ctx);
+
+	lines = dump_lines(ctx);
+	if (lines != PERF_TABLE_ROWS + 2 || state->total != total) {
+		fprintf(stderr, "dump of filtered page: %d lines, %d shown\n",
+			lines, state->total);
+		failed = 1;
+	}
+
+	/* the lines left out are split again */
+	top_record_keys(&rec, PERF_FILTER_WIDEN, strlen(PERF_FILTER_WIDEN));
+	top_ui_main_loop(ctx);
+
+	if (state->total != PERF_TABLE_ROWS) {
+		fprintf(stderr, "widened filter: %d lines\n", state->total);
+		failed = 1;
+	}
+
+	ctx->filter[0] = 0;
+}
+
+static void search_check(struct top_context *ctx)
+{
+	struct top_search_result result[ARRAY_SIZE(page)];
+	int num;
+
+	/* the row is on both pages of the file */
+	num = top_search(ctx, PERF_SEARCH, result, ARRAY_SIZE(result));
+	if (num != 2 || result[0].line != PERF_TABLE_ROWS ||
+	    result[1].page_idx != 1) {
+		fprintf(stderr, "search: %d matches\n", num);
+		failed = 1;
+	}
+
+	num = top_search(ctx, PERF_SEARCH_ABSENT, result, ARRAY_SIZE(result));
+	if (num != 0) {
+		fprintf(stderr, "search of absent text: %d matches\n", num);
+		failed = 1;
+	}
+
+	budget_check("pages scanned for absent text",
+		     top_search_scanned_get(ctx), BUDGET_SEARCH_SCANNED);
+
+	/* picking the first match jumps there */
+	top_record_keys(&rec, PERF_SEARCH_KEYS, strlen(PERF_SEARCH_KEYS));
+	top_ui_main_loop(ctx);
+
+	if (ctx->page_sel != 0 ||
+	    ctx->page_state[0].start != PERF_TABLE_ROWS) {
+		fprintf(stderr, "search jumped to page %u line %d\n",
+			ctx->page_sel, ctx->page_state[ctx->page_sel].start);
+		failed = 1;
+	}
+}
+
+static void watch_check(struct top_context *ctx)
+{
+	const struct top_prof_page *pp = &ctx->prof.page[PERF_PAGE_WATCH];
+	struct top_search_result result[ARRAY_SIZE(page)];
+	char keys[PERF_KEYS + 1];
+	unsigned int i;
+	int num;
+
+	for (i = 0; i < ARRAY_SIZE(watch_pin); i++) {
+		if (top_watch_pin_parse(ctx, watch_pin[i]) == 0)
+			continue;
+
+		fprintf(stderr, "%s: can't pin\n", watch_pin[i]);
+		failed = 1;
+	}
+
+	/* no frame of the pinned pages in between */
+	top_select_group(ctx, page[PERF_PAGE_WATCH].name);
+	top_prof_reset(ctx);
+	line_get_calls = 0;
+
+	keys[0] = 0;
+	keys_add(keys, sizeof(keys), "w", PERF_KEYS);
+	top_record_keys(&rec, keys, strlen(keys));
+	top_ui_main_loop(ctx);
+
+	for (i = 0; i < ARRAY_SIZE(watch_pin); i++) {
+		if (!strstr(ctx->shared_buff[i], "(not found)"))
+			continue;
+
+		fprintf(stderr, "%s: not found\n", watch_pin[i]);
+		failed = 1;
+	}
+
+	budget_check("syscalls per watch fetch", pp->syscalls / pp->fetches,
+		     BUDGET_WATCH_SYSCALLS);
+	budget_check("line_get calls of pinned pages", line_get_calls,
+		     BUDGET_WATCH_LINE_GET);
+
+	/* the watch page only repeats rows of the other pages; the snapshots
+	 * taken before the rows were pinned are dropped */
+	top_select_group(ctx, page[0].name);
+	snapshot_cache_free(ctx);
+	num = top_search(ctx, PERF_SEARCH, result, ARRAY_SIZE(result));
+	if (num != 2) {
+		fprintf(stderr, "search with pinned rows: %d matches\n", num);
+		failed = 1;
+	}
+}
+
+static void split_check(struct top_context *ctx)
+{
+	const struct top_snapshot *snap;
+	unsigned int i;
+
+	/* a pane for each page, the second one focused */
+	top_select_group(ctx, page[0].name);
+	top_record_keys(&rec, PERF_KEY_SPLIT PERF_KEY_SPLIT PERF_KEY_PANE, 3);
+	top_ui_main_loop(ctx);
+
+	if (ctx->pane_num != ARRAY_SIZE(page) || ctx->pane_sel != 1 ||
+	    ctx->page_sel != 1) {
+		fprintf(stderr, "split: %u panes, pane %u page %u selected\n",
+			ctx->pane_num, ctx->pane_sel, ctx->page_sel);
+		failed = 1;
+	}
+
+	/* the shared buffer holds the focused page only */
+	for (i = 0; i < ctx->pane_num; i++) {
+		if (i == ctx->pane_sel)
+			continue;
+
+		snap = snapshot_cache_peek(ctx, ctx->pane[i]);
+		if (ctx->pane[i] != i || !snap ||
+		    ctx->pane_gen[i] != snap->gen) {
+			fprintf(stderr, "pane %u not drawn from the cache\n", i);
+			failed = 1;
+		}
+	}
+
+	/* the focused last pane doesn't fit the smaller terminal */
+	top_record_keys(&rec, PERF_KEY_PANE, 1);
+	top_ui_main_loop(ctx);
+	rec.rows = PERF_SPLIT_ROWS;
+	ctx->need_resize = 1;
+	top_record_keys(&rec, "", 0);
+	top_ui_main_loop(ctx);
+
+	/* the second pane keeps its page and takes the focus */
+	if (ctx->pane_num != 2 || ctx->pane_sel != 1 || ctx->pane[1] != 1 ||
+	    ctx->page_sel != 1) {
+		fprintf(stderr, "resize: %u panes, pane %u page %u selected\n",
+			ctx->pane_num, ctx->pane_sel, ctx->page_sel);
+		failed = 1;
+	}
+
+	/* no room for another pane, back to one */
+	top_record_keys(&rec, PERF_KEY_SPLIT, 1);
+	top_ui_main_loop(ctx);
+
+	if (ctx->pane_num != 1 || ctx->pane_sel != 0 ||
+	    ctx->pane[0] != ctx->page_sel) {
+		fprintf(stderr, "unsplit: %u panes\n", ctx->pane_num);
+		failed = 1;
+	}
+
+	rec.rows = PERF_ROWS;
+	ctx->need_resize = 1;
+}
+
+static void batch_check(struct top_context *ctx, const char *root)
+{
+	const struct top_prof_page *pp = &ctx->prof.page[0];
+	char path[96];
+
+	snprintf(path, sizeof(path), "%s/batch.txt", root);
+
+	line_get_calls = 0;
+	top_batch(ctx, path);
+
+	budget_check("syscalls per batch fetch", pp->syscalls / pp->fetches,
+		     BUDGET_REFRESH_SYSCALLS);
+	budget_check("line_get calls per written line",
+		     line_get_calls / (ctx->page_state[0].total + 1),
+		     BUDGET_WRITE_LINE_GET);
+	budget_check("bytes per written table", pp->bytes_written,
+		     BUDGET_WRITE_BYTES);
+}
+
+static void batch_list_check(struct top_context *ctx, const char *root)
+{
+	const struct top_prof_page *pp = &ctx->prof.page[1];
+	char path[96], line[TOP_LINE_LEN];
+	unsigned int num = 0;
+	FILE *f;
+
+	snprintf(path, sizeof(path), "%s/batch_list.txt", root);
+
+	if (top_batch_pages_set(ctx, PERF_BATCH_PAGES)) {
+		fprintf(stderr, "%s: can't set batch pages\n",
+			PERF_BATCH_PAGES);
+		failed = 1;
+		return;
+	}
+	top_batch_repeat_set(ctx, PERF_BATCH_COUNT, PERF_BATCH_INTERVAL);
+
+	top_prof_reset(ctx);
+	top_batch(ctx, path);
+
+	f = fopen(path, "r");
+	while (f && fgets(line, sizeof(line), f)) {
+		if (strncmp(line, "Page: ", 6) != 0)
+			continue;
+
+		if (num >= ARRAY_SIZE(batch_page) ||
+		    strncmp(line, batch_page[num],
+			    strlen(batch_page[num])) != 0 ||
+		    !strchr(" \r\n", line[strlen(batch_page[num])])) {
+			fprintf(stderr, "batch page %u: %s", num, line);
+			failed = 1;
+		}
+		num++;
+	}
+	if (f)
+		fclose(f);
+
+	if (num != ARRAY_SIZE(batch_page)) {
+		fprintf(stderr, "batch list: %u pages written\n", num);
+		failed = 1;
+	}
+
+	budget_check("syscalls per listed page fetch",
+		     pp->syscalls / pp->fetches, BUDGET_REFRESH_SYSCALLS);
+	budget_check("fetches of unlisted pages",
+		     ctx->prof.page[PERF_PAGE_WATCH].fetches,
+		     BUDGET_BATCH_UNLISTED_FETCHES);
+}
+
+static void line_rate_check(struct top_context *ctx)
+{
+	char keys[PERF_KEYS * 8 + 1];
+	uint64_t start, allowed;
+
+	/* the refresh of an unchanged page sends no cells */
+	top_line_rate_set(ctx, PERF_LINE_RATE_FAST);
+	top_select_group(ctx, page[0].name);
+	ctx->page_state[0].start = 0;
+	top_record_keys(&rec, "", 0);
+	top_ui_main_loop(ctx);
+
+	top_record_reset(&rec);
+	keys[0] = 0;
+	keys_add(keys, sizeof(keys), "a", PERF_KEYS);
+	top_record_keys(&rec, keys, strlen(keys));
+	top_ui_main_loop(ctx);
+
+	budget_check("bytes per unchanged frame", rec.bytes / rec.frames,
+		     BUDGET_SCREEN_UNCHANGED_BYTES);
+
+	/* scrolling faster than the console shows the lines */
+	top_line_rate_set(ctx, PERF_LINE_RATE_SLOW);
+	top_record_reset(&rec);
+	keys[0] = 0;
+	keys_add(keys, sizeof(keys), PERF_KEY_DOWN, PERF_KEYS);
+	start = top_time_us();
+	top_record_keys(&rec, keys, strlen(keys));
+	top_ui_main_loop(ctx);
+
+	allowed = (top_time_us() - start) * (PERF_LINE_RATE_SLOW / 10) /
+		  1000000 + PERF_LINE_RATE_SLOW / 10 * TOP_SCREEN_BURST / 1000;
+	budget_check("bytes over the line rate",
+		     rec.bytes > allowed ? rec.bytes - allowed : 0,
+		     BUDGET_SCREEN_EXCESS_BYTES);
+
+	if (!ctx->screen->dropped && !ctx->screen->partial) {
+		fprintf(stderr, "line rate: all frames sent whole\n");
+		failed = 1;
+	}
+
+	top_line_rate_set(ctx, 0);
+}
+
+static void burst_check(struct top_context *ctx)
+{
+	char keys[PERF_KEYS * 16 + 1];
+	uint64_t reads;
+
+	/* a pasted filter and keys held down over a slow link arrive in one
+	 * read */
+	keys[0] = 0;
+	keys_add(keys, sizeof(keys), PERF_PASTE, 1);
+	keys_add(keys, sizeof(keys), PERF_KEY_DOWN, PERF_KEYS);
+	keys_add(keys, sizeof(keys), PERF_KEY_DOWN_SS3, PERF_KEYS);
+	keys_add(keys, sizeof(keys), PERF_KEY_DOWN_CTRL, PERF_KEYS);
+
+	top_select_group(ctx, page[0].name);
+	ctx->page_state[0].start = 0;
+	top_record_keys(&rec, "", 0);
+	top_ui_main_loop(ctx);
+
+	top_record_reset(&rec);
+	reads = ctx->input.reads;
+	ctx->page_state[0].start = 0;
+	top_record_keys(&rec, keys, strlen(keys));
+	rec.burst = true;
+	top_ui_main_loop(ctx);
+
+	if (ctx->page_state[0].start != PERF_PASTE_LINE ||
+	    strcmp(ctx->filter, PERF_FILTER)) {
+		fprintf(stderr, "burst: start %d, filter \"%s\"\n",
+			ctx->page_state[0].start, ctx->filter);
+		failed = 1;
+	}
+
+	budget_check("frames per key burst", rec.frames, BUDGET_BURST_FRAMES);
+	budget_check("reads per key burst", ctx->input.reads - reads,
+		     BUDGET_BURST_READS);
+
+	ctx->filter[0] = 0;
+}
+
+static void scroll_check(struct top_context *ctx)
+{
+	char keys[PERF_KEYS * 8 + 1];
+	uint64_t bytes;
+
+	top_select_group(ctx, page[0].name);
+	ctx->page_state[0].start = 0;
+	top_record_reset(&rec);
+	top_record_keys(&rec, "", 0);
+	top_ui_main_loop(ctx);
+	bytes = rec.bytes;
+
+	/* one line down and up again, each key in a frame of its own */
+	keys[0] = 0;
+	keys_add(keys, sizeof(keys), PERF_KEY_DOWN, PERF_KEYS);
+	keys_add(keys, sizeof(keys), PERF_KEY_UP, PERF_KEYS);
+
+	ctx->page_state[0].start = 0;
+	top_record_reset(&rec);
+	top_record_keys(&rec, keys, strlen(keys));
+	top_ui_main_loop(ctx);
+
+	if (rec.calls[TOP_RECORD_SCROLL] != 2 * PERF_KEYS) {
+		fprintf(stderr, "scroll: %llu of %u frames scrolled\n",
+			(unsigned long long)rec.calls[TOP_RECORD_SCROLL],
+			2 * PERF_KEYS);
+		failed = 1;
+	}
+
+	budget_check("bytes per scrolled line",
+		     (rec.bytes - bytes) / (2 * PERF_KEYS),
+		     BUDGET_SCROLL_BYTES);
+}
+
+static void batch_repeat_check(struct top_context *ctx, const char *root)
+{
+	char path[96], line[TOP_LINE_LEN];
+	unsigned int num = 0;
+	FILE *f;
+
+	snprintf(path, sizeof(path), "%s/batch_all.txt", root);
+
+	/* all pages, every sample appended */
+	top_batch_repeat_set(ctx, PERF_BATCH_COUNT, PERF_BATCH_INTERVAL);
+	top_batch(ctx, path);
+
+	f = fopen(path, "r");
+	while (f && fgets(line, sizeof(line), f))
+		if (strncmp(line, "Page: ", 6) == 0)
+			num++;
+	if (f)
+		fclose(f);
+
+	if (num != PERF_BATCH_COUNT * ARRAY_SIZE(page)) {
+		fprintf(stderr, "batch of all pages: %u pages written\n", num);
+		failed = 1;
+	}
+}
+
+static int context_init(struct top_context *ctx, const char *root)
+{
+	/* the update timer must not add frames */
+	if (top_init(ctx, &record_top_ops, -1, page, ARRAY_SIZE(page), NULL, 0,
+		     3600 * 1000, NULL, NULL, &rec))
+		return -1;
+
+	return top_proc_root_set(ctx, root);
+}
+
+int main(void)
+{
+	struct top_context *ctx;
+	char root[64];
+
+	if (procgen_root_create(root, sizeof(root)))
+		return 1;
+
+	if (procgen_table(root, page[0].input_file_name, PERF_TABLE_ROWS,
+			  PERF_TABLE_COLS, 0)) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	ctx = malloc(sizeof(*ctx));
+	if (!ctx || context_init(ctx, root)) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	top_record_init(&rec, PERF_ROWS, PERF_COLS);
+	top_dump_dir_set(ctx, root);
+	top_ui_prepare(ctx);
+
+	refresh_check(ctx);
+	nav_check(ctx, "line_get calls per key", BUDGET_NAV_LINE_GET);
+	strcpy(ctx->filter, PERF_FILTER);
+	nav_check(ctx, "line_get calls per filtered key",
+		  BUDGET_FILTER_NAV_LINE_GET);
+	ctx->filter[0] = 0;
+	line_rate_check(ctx);
+	burst_check(ctx);
+	scroll_check(ctx);
+	/* the dump status in the footer adds to the output bytes from here */
+	prefetch_check(ctx);
+	filter_check(ctx);
+	search_check(ctx);
+	watch_check(ctx);
+	split_check(ctx);
+
+	top_ui_shutdown(ctx);
+	top_shutdown(ctx);
+
+	/* batch mode writes all pages of a fresh context */
+	if (context_init(ctx, root)) {
+		failed = 1;
+	} else {
+		batch_check(ctx, root);
+		batch_repeat_check(ctx, root);
+		batch_list_check(ctx, root);
+		top_shutdown(ctx);
+	}
+
+	free(ctx);
+	procgen_root_remove(root);
+
+	return failed;
+}
@@ -0,0 +1,246 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* A client fetches its pages from a snapshot server running in a thread; a
+   page the server can't serve fails alone, the client stays attached. The
+   received text is hashed and filtered like a local read. The server
+   replaces a stale socket, but not the socket of a running server. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "procgen.h"
+
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/** Rows of the generated tables */
+#define REMOTE_ROWS 10
+
+/** Number of connection attempts (10 ms apart) waiting for the server */
+#define REMOTE_WAIT 100
+
+/** Update interval (in ms) */
+#define REMOTE_INTERVAL 100
+
+/** Filter matching one row of the generated tables */
+#define REMOTE_FILTER "port7"
+
+/** Pages of the server */
+static const struct top_page_desc server_page[] = {
+	ONU_CNT_PROC(0, 's', "shared", "shared")
+};
+
+/** Pages of the client; the server doesn't know "local" */
+static const struct top_page_desc client_page[] = {
+	ONU_CNT_PROC(0, 's', "shared", "shared")
+	ONU_CNT_PROC(0, 'l', "local", "local")
+};
+
+enum {
+	PAGE_SHARED,
+	PAGE_LOCAL
+};
+
+static struct top_record rec;
+static int failed;
+
+static void check(bool ok, const char *what)
+{
+	if (ok)
+		return;
+
+	fprintf(stderr, "%s\n", what);
+	failed = 1;
+}
+
+struct server_arg {
+	struct top_context *ctx;
+	char path[96];
+};
+
+static void *server_thread(void *arg)
+{
+	struct server_arg *srv = arg;
+
+	if (top_server_run(srv->ctx, srv->path))
+		check(false, "server not started");
+
+	return NULL;
+}
+
+static void remote_check(struct top_context *ctx, const char *path)
+{
+	unsigned int i;
+	uint64_t hash;
+	int total;
+
+	for (i = 0; i < REMOTE_WAIT && top_remote_attach(ctx, path); i++)
+		usleep(10 * 1000);
+
+	if (!ctx->remote) {
+		check(false, "can't attach to the server");
+		return;
+	}
+
+	total = counters_fetch(ctx, PAGE_SHARED);
+	check(total == REMOTE_ROWS + 1, "shared page not fetched");
+
+	/* not read locally although the file is there */
+	total = counters_fetch(ctx, PAGE_LOCAL);
+	check(total == 0, "unknown page has lines");
+	check(ctx->remote != NULL, "detached after an error reply");
+
+	total = counters_fetch(ctx, PAGE_SHARED);
+	check(total == REMOTE_ROWS + 1, "shared page lost after the error");
+
+	/* the text is hashed and parsed like a local read */
+	hash = ctx->fetch_hash;
+	check(hash != 0, "remote page not hashed");
+	(void)counters_fetch(ctx, PAGE_SHARED);
+	check(ctx->fetch_hash == hash &&
+	      top_page_interval_get(ctx, PAGE_SHARED) > REMOTE_INTERVAL,
+	      "unchanged remote page doesn't back off");
+
+	strcpy(ctx->filter, REMOTE_FILTER);
+	ctx->fetch_filter = true;
+	total = counters_fetch(ctx, PAGE_SHARED);
+	ctx->fetch_filter = false;
+	ctx->filter[0] = 0;
+	check(total == 1, "filter not applied to the remote page");
+
+	top_remote_detach(ctx);
+}
+
+/** Leave a socket file behind, as a server which crashed does
+
+   \return 0 on success; -1 on error
+*/
+static int stale_socket_create(const char *path)
+{
+	struct sockaddr_un addr;
+	int fd, ret;
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+	ret = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+	close(fd);
+
+	return ret;
+}
+
+/** A second server must not take over the socket of the running one */
+static void second_check(struct top_context *second, struct top_context *ctx,
+			 const char *path)
+{
+	/* returns right away if it starts at all */
+	top_ui_stop(second);
+	check(top_server_run(second, path) != 0,
+	      "second server started on the socket");
+
+	check(top_remote_attach(ctx, path) == 0,
+	      "socket of the running server removed");
+	top_remote_detach(ctx);
+}
+
+/** Initialize context reading the tables of root
+
+   \return 0 on success; -1 on error
+*/
+static int context_init(struct top_context *ctx,
+			const struct top_page_desc *page, unsigned int num,
+			const char *root)
+{
+	if (top_init(ctx, &record_top_ops, -1, page, num, NULL, 0,
+		     REMOTE_INTERVAL, NULL, NULL, &rec))
+		return -1;
+
+	if (top_proc_root_set(ctx, root)) {
+		top_shutdown(ctx);
+		return -1;
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	static struct top_context server, client, second;
+	struct server_arg arg;
+	pthread_t thread;
+	char root[64];
+	unsigned int i;
+
+	if (procgen_root_create(root, sizeof(root)))
+		return 1;
+
+	for (i = 0; i < ARRAY_SIZE(client_page); i++) {
+		if (procgen_table(root, client_page[i].input_file_name,
+				  REMOTE_ROWS, 4, i)) {
+			procgen_root_remove(root);
+			return 1;
+		}
+	}
+
+	arg.ctx = &server;
+	snprintf(arg.path, sizeof(arg.path), "%s/top.sock", root);
+
+	/* the server replaces the socket */
+	if (stale_socket_create(arg.path)) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	if (context_init(&server, server_page, ARRAY_SIZE(server_page), root)) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	if (context_init(&client, client_page, ARRAY_SIZE(client_page),
+			 root)) {
+		top_shutdown(&server);
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	if (context_init(&second, server_page, ARRAY_SIZE(server_page),
+			 root)) {
+		top_shutdown(&client);
+		top_shutdown(&server);
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	if (pthread_create(&thread, NULL, server_thread, &arg)) {
+		top_shutdown(&second);
+		top_shutdown(&client);
+		top_shutdown(&server);
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	remote_check(&client, arg.path);
+	second_check(&second, &client, arg.path);
+
+	top_ui_stop(&server);
+	pthread_join(thread, NULL);
+
+	top_shutdown(&second);
+	top_shutdown(&client);
+	top_shutdown(&server);
+	procgen_root_remove(root);
+
+	return failed;
+}
@@ -0,0 +1,238 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* Pages with a data source: a procfs source reads the same table as a
+   proc page, an ioctl source formats the argument of the call and refuses
+   an oversized one, and a notifying source whose file can't be polled is
+   fetched on every update. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "procgen.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+/** Rows and columns of the generated table */
+#define SOURCE_ROWS 10
+#define SOURCE_COLS 4
+
+/** Bytes queued in the pipe read by the ioctl source */
+#define SOURCE_QUEUED 5
+
+static size_t queued_format(struct top_context *ctx, const void *arg,
+			    char *text, size_t size);
+
+static const struct top_source proc_src = {
+	.type = TOP_SOURCE_PROC,
+	.path = "driver/onu/source"
+};
+
+static const struct top_source debugfs_src = {
+	.type = TOP_SOURCE_DEBUGFS,
+	.path = "onu/source"
+};
+
+static const struct top_source ioctl_src = {
+	.type = TOP_SOURCE_IOCTL,
+	.request = FIONREAD,
+	.arg_size = sizeof(int),
+	.format = queued_format
+};
+
+static const struct top_source oversized_src = {
+	.type = TOP_SOURCE_IOCTL,
+	.request = FIONREAD,
+	.arg_size = TOP_SOURCE_ARG_MAX + 1,
+	.format = queued_format
+};
+
+/** Notifying source; its file is opened by the test */
+static const struct top_source notify_src = {
+	.type = TOP_SOURCE_SYSFS,
+	.path = "class/onu/source",
+	.notify = true
+};
+
+static const struct top_page_desc page[] = {
+	ONU_CNT_PROC(0, 'p', "proc", "source")
+	CNT_SOURCE(0, 's', "proc source", &proc_src)
+	CNT_SOURCE(0, 'd', "debugfs source", &debugfs_src)
+	CNT_SOURCE(0, 'i', "ioctl source", &ioctl_src)
+	CNT_SOURCE(0, 'o', "oversized ioctl source", &oversized_src)
+	CNT_SOURCE(0, 'n', "notifying source", &notify_src)
+};
+
+enum {
+	PAGE_PROC,
+	PAGE_PROC_SOURCE,
+	PAGE_DEBUGFS_SOURCE,
+	PAGE_IOCTL,
+	PAGE_IOCTL_OVERSIZED,
+	PAGE_NOTIFY
+};
+
+static struct top_record rec;
+static unsigned int format_calls;
+static int failed;
+
+static void check(bool ok, const char *what)
+{
+	if (ok)
+		return;
+
+	fprintf(stderr, "%s\n", what);
+	failed = 1;
+}
+
+static size_t queued_format(struct top_context *ctx, const void *arg,
+			    char *text, size_t size)
+{
+	int len;
+
+	format_calls++;
+
+	len = snprintf(text, size, "name value\nqueued %d\n",
+		       *(const int *)arg);
+
+	return len < 0 ? 0 : (size_t)len;
+}
+
+/** Fetch page and copy its lines
+
+   \return Number of lines
+*/
+static int fetch(struct top_context *ctx, unsigned int page_idx,
+		 char (*line)[TOP_LINE_LEN], unsigned int num)
+{
+	char buff[TOP_LINE_LEN];
+	const char *p;
+	int total, i;
+
+	total = counters_fetch(ctx, page_idx);
+
+	for (i = 0; i < total && i < (int)num; i++) {
+		buff[0] = 0;
+		p = ctx->page[page_idx].line_get(ctx, i, buff);
+		snprintf(line[i], TOP_LINE_LEN, "%s", p ? p : buff);
+	}
+
+	return total;
+}
+
+static void file_check(struct top_context *ctx)
+{
+	static char expect[SOURCE_ROWS + 1][TOP_LINE_LEN];
+	static char line[SOURCE_ROWS + 1][TOP_LINE_LEN];
+	char path[TOP_PROC_ROOT_LEN + TOP_LINE_LEN];
+	int total, i;
+
+	total = fetch(ctx, PAGE_PROC, expect, ARRAY_SIZE(expect));
+	check(total == SOURCE_ROWS + 1, "proc page not read");
+
+	check(fetch(ctx, PAGE_PROC_SOURCE, line, ARRAY_SIZE(line)) == total,
+	      "proc source differs from the proc page");
+	for (i = 0; i < total && i < (int)ARRAY_SIZE(line); i++) {
+		if (strcmp(line[i], expect[i]) == 0)
+			continue;
+
+		check(false, "line of the proc source differs");
+		break;
+	}
+
+	/* debugfs isn't below the procfs root */
+	check(source_path(ctx, &debugfs_src, path, sizeof(path)) == 0 &&
+	      strcmp(path, TOP_DEBUGFS_ROOT "/onu/source") == 0,
+	      "wrong debugfs path");
+	check(source_path(ctx, &ioctl_src, path, sizeof(path)) != 0,
+	      "ioctl source has a path");
+}
+
+static void ioctl_check(struct top_context *ctx)
+{
+	static char line[2][TOP_LINE_LEN];
+	const struct top_prof_page *pp =
+		&ctx->prof.page[PAGE_IOCTL_OVERSIZED];
+	char expect[TOP_LINE_LEN];
+
+	format_calls = 0;
+	check(fetch(ctx, PAGE_IOCTL, line, ARRAY_SIZE(line)) == 2,
+	      "ioctl source not read");
+	snprintf(expect, sizeof(expect), "queued %d", SOURCE_QUEUED);
+	check(strncmp(line[1], expect, strlen(expect)) == 0,
+	      "ioctl result not formatted");
+
+	/* refused before the call */
+	format_calls = 0;
+	check(counters_fetch(ctx, PAGE_IOCTL_OVERSIZED) == 0,
+	      "oversized ioctl argument accepted");
+	check(pp->fetches == 1 && pp->syscalls == 0 && format_calls == 0,
+	      "ioctl called with an oversized argument");
+}
+
+static void notify_check(struct top_context *ctx, const char *root)
+{
+	struct top_page_state *state = &ctx->page_state[PAGE_NOTIFY];
+	char path[TOP_PROC_ROOT_LEN + TOP_LINE_LEN];
+
+	check(source_changed(ctx, PAGE_NOTIFY),
+	      "unopened source not fetched");
+
+	/* a regular file never signals POLLPRI */
+	snprintf(path, sizeof(path), "%s/driver/onu/%s", root,
+		 page[PAGE_PROC].input_file_name);
+	state->source_fd = open(path, O_RDONLY);
+	check(state->source_fd >= 0 && source_notifies(ctx, PAGE_NOTIFY),
+	      "notifying source not open");
+	check(!source_changed(ctx, PAGE_NOTIFY), "unchanged source fetched");
+
+	/* closed behind the back of the page */
+	close(state->source_fd);
+	check(source_changed(ctx, PAGE_NOTIFY),
+	      "source which can't be polled not fetched");
+	state->source_fd = -1;
+}
+
+int main(void)
+{
+	static struct top_context ctx;
+	char root[64];
+	int fd[2];
+
+	if (procgen_root_create(root, sizeof(root)))
+		return 1;
+
+	if (procgen_table(root, page[PAGE_PROC].input_file_name, SOURCE_ROWS,
+			  SOURCE_COLS, 0) || pipe(fd)) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	if (write(fd[1], "queue", SOURCE_QUEUED) != SOURCE_QUEUED ||
+	    top_init(&ctx, &record_top_ops, fd[0], page, ARRAY_SIZE(page),
+		     NULL, 0, 100, NULL, NULL, &rec) ||
+	    top_proc_root_set(&ctx, root)) {
+		close(fd[0]);
+		close(fd[1]);
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	file_check(&ctx);
+	ioctl_check(&ctx);
+	notify_check(&ctx, root);
+
+	top_shutdown(&ctx);
+	close(fd[0]);
+	close(fd[1]);
+	procgen_root_remove(root);
+
+	return failed;
+}
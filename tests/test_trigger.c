@@ -0,0 +1,244 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* Trigger conditions given as text are accepted only if every numeric
+   field parses as a number without trailing text and no field is left
+   over. A sequence of fetches fires delta and range conditions; the dump
+   holds the pre- and post-trigger windows and the trigger re-arms, also
+   after a dump which can't be written. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "procgen.h"
+
+#include <dirent.h>
+#include <unistd.h>
+
+/** Snapshots before (the firing one included) and after the trigger */
+#define TRIGGER_PRE 2
+#define TRIGGER_POST 2
+
+/** Suffix of the dump files */
+#define TRIGGER_DUMP_SUFFIX "_trigger.txt"
+
+static const struct top_page_desc page[] = {
+	ONU_CNT_PROC(0, 't', "Trigger Page", "trigger")
+};
+
+/** Condition and whether it has to be accepted */
+static const struct {
+	const char *spec;
+	bool ok;
+} cond[] = {
+	{ "t:row:cnt1:delta:10", true },
+	{ "t:row:cnt1:delta:-1.5e3", true },
+	{ "t:row:cnt1:range:-20.5:0", true },
+	{ "t:row:cnt1:delta:abc", false },
+	{ "t:row:cnt1:delta:", false },
+	{ "t:row:cnt1:delta:10ms", false },
+	{ "t:row:cnt1:delta:10:20", false },
+	{ "t:row:cnt1:range:1:x", false },
+	{ "t:row:cnt1:range::5", false },
+	{ "t:row:cnt1:range:1:5:9", false },
+	{ "x:row:cnt1:delta:10", false },
+	{ "t:row:cnt1:level:10", false }
+};
+
+static struct top_record rec;
+static int failed;
+
+static void check(bool ok, const char *what)
+{
+	if (ok)
+		return;
+
+	fprintf(stderr, "%s\n", what);
+	failed = 1;
+}
+
+static void parse_check(void)
+{
+	static struct top_context ctx;
+	unsigned int i;
+
+	if (top_init(&ctx, &record_top_ops, -1, page, ARRAY_SIZE(page), NULL,
+		     0, 100, NULL, NULL, &rec) ||
+	    top_trigger_init(&ctx, TRIGGER_PRE, TRIGGER_POST, 0)) {
+		check(false, "can't set up the parser");
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(cond); i++) {
+		if ((top_trigger_cond_parse(&ctx, cond[i].spec) == 0) ==
+		    cond[i].ok)
+			continue;
+
+		fprintf(stderr, "condition \"%s\" %s\n", cond[i].spec,
+			cond[i].ok ? "rejected" : "accepted");
+		failed = 1;
+	}
+
+	top_shutdown(&ctx);
+}
+
+/** Write the page and fetch it */
+static void fetch(struct top_context *ctx, const char *root, int rx, int tx)
+{
+	char path[256];
+	FILE *f;
+
+	snprintf(path, sizeof(path), "%s/driver/onu/%s", root,
+		 page[0].input_file_name);
+	f = fopen(path, "w");
+	if (!f) {
+		check(false, "can't write the page");
+		return;
+	}
+
+	fprintf(f, "name value\nrx %d\ntx %d\n", rx, tx);
+	fclose(f);
+
+	if (counters_fetch(ctx, 0) < 0)
+		check(false, "page not fetched");
+}
+
+/** Read and remove the dumps written since the last call
+
+   \param[out] text Contents of the last dump
+   \param[in]  size Size of text
+
+   \return Number of dumps
+*/
+static unsigned int dump_take(const char *root, char *text, size_t size)
+{
+	char path[256];
+	unsigned int num = 0;
+	struct dirent *de;
+	size_t len, n;
+	DIR *dir;
+	FILE *f;
+
+	text[0] = 0;
+
+	dir = opendir(root);
+	if (!dir)
+		return 0;
+
+	while ((de = readdir(dir)) != NULL) {
+		len = strlen(de->d_name);
+		if (len < strlen(TRIGGER_DUMP_SUFFIX) ||
+		    strcmp(de->d_name + len - strlen(TRIGGER_DUMP_SUFFIX),
+			   TRIGGER_DUMP_SUFFIX))
+			continue;
+
+		snprintf(path, sizeof(path), "%s/%s", root, de->d_name);
+		f = fopen(path, "r");
+		if (f) {
+			n = fread(text, 1, size - 1, f);
+			text[n] = 0;
+			fclose(f);
+		}
+		unlink(path);
+		num++;
+	}
+	closedir(dir);
+
+	return num;
+}
+
+/** Check dump for a line of row rx */
+static bool dump_has_rx(const char *text, int rx)
+{
+	char line[32];
+
+	snprintf(line, sizeof(line), "\nrx %d" TOP_CRLF, rx);
+
+	return strstr(text, line) != NULL;
+}
+
+static void fire_check(struct top_context *ctx, const char *root)
+{
+	static char text[16384];
+	char missing[128];
+
+	/* delta fires on the fourth fetch, written after the post window */
+	fetch(ctx, root, 100, 5);
+	fetch(ctx, root, 101, 5);
+	fetch(ctx, root, 102, 5);
+	fetch(ctx, root, 150, 5);
+	fetch(ctx, root, 151, 5);
+	check(dump_take(root, text, sizeof(text)) == 0,
+	      "dump written before the post window");
+	fetch(ctx, root, 152, 5);
+	check(dump_take(root, text, sizeof(text)) == 1, "delta didn't fire");
+	check(strstr(text, "Trigger: Trigger Page/rx/value delta > 10, "
+			   "value 150 at ") == text,
+	      "wrong delta trigger");
+	check(!dump_has_rx(text, 101) && dump_has_rx(text, 102) &&
+	      dump_has_rx(text, 150) && dump_has_rx(text, 151) &&
+	      dump_has_rx(text, 152), "wrong delta windows");
+
+	/* re-armed */
+	fetch(ctx, root, 153, 5000);
+	fetch(ctx, root, 154, 5);
+	fetch(ctx, root, 155, 5);
+	check(dump_take(root, text, sizeof(text)) == 1, "range didn't fire");
+	check(strstr(text, "Trigger: Trigger Page/tx/value outside 0..1000, "
+			   "value 5000 at ") == text,
+	      "wrong range trigger");
+
+	/* the dump can't be written; its windows are dropped */
+	snprintf(missing, sizeof(missing), "%s/missing", root);
+	top_dump_dir_set(ctx, missing);
+	fetch(ctx, root, 500, 5);
+	fetch(ctx, root, 501, 5);
+	fetch(ctx, root, 502, 5);
+	top_dump_dir_set(ctx, root);
+
+	fetch(ctx, root, 503, 5);
+	fetch(ctx, root, 600, 5);
+	fetch(ctx, root, 601, 5);
+	fetch(ctx, root, 602, 5);
+	check(dump_take(root, text, sizeof(text)) == 1,
+	      "not re-armed after a failed dump");
+	check(strstr(text, "value 600 at ") != NULL,
+	      "wrong trigger after a failed dump");
+	check(!dump_has_rx(text, 502) && dump_has_rx(text, 503) &&
+	      dump_has_rx(text, 602), "windows of the failed dump reused");
+}
+
+int main(void)
+{
+	static struct top_context ctx;
+	char root[64];
+
+	parse_check();
+
+	if (procgen_root_create(root, sizeof(root)))
+		return 1;
+
+	/* dumps are written directly without the writer thread */
+	if (top_init(&ctx, &record_top_ops, -1, page, ARRAY_SIZE(page), NULL,
+		     0, 100, NULL, NULL, &rec) ||
+	    top_proc_root_set(&ctx, root) ||
+	    top_trigger_init(&ctx, TRIGGER_PRE, TRIGGER_POST, 0) ||
+	    top_trigger_cond_parse(&ctx, "t:rx:value:delta:10") ||
+	    top_trigger_cond_parse(&ctx, "t:tx:value:range:0:1000")) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	top_dump_dir_set(&ctx, root);
+	fire_check(&ctx, root);
+
+	top_shutdown(&ctx);
+	procgen_root_remove(root);
+
+	return failed;
+}
@@ -0,0 +1,273 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2026 MaxLinear, Inc.
+ *
+ * For licensing information, see the file 'LICENSE' in the root folder of
+ * this software module.
+ *
+ ******************************************************************************/
+
+/* Dumps are filled in one buffer of the writer thread while the other one
+   is written; a third dump is refused while both are busy. Every queued
+   dump reaches its file with each flush policy, also when the writer is
+   stopped right after queuing; the status reports the saved dumps and a
+   dump which can't be written. Without the writer thread dumps are written
+   directly. */
+
+#include "gpon_libs_config.h"
+#include "top.h"
+#include "procgen.h"
+
+#include <unistd.h>
+
+/** Dumps queued with each flush policy */
+#define WRITER_DUMPS 8
+
+/** Lines of each dump */
+#define WRITER_LINES 1000
+
+/** Upper limit (in ms) of a wait for the writer thread */
+#define WRITER_WAIT_MS 5000
+
+static const struct top_page_desc page[] = {
+	ONU_CNT_PROC(0, 'w', "writer", "writer")
+};
+
+static const enum top_fsync_policy policy[] = {
+	TOP_FSYNC_NONE, TOP_FSYNC_FILE, TOP_FSYNC_DIR
+};
+
+static struct top_record rec;
+static int failed;
+
+static void check(bool ok, const char *what)
+{
+	if (ok)
+		return;
+
+	fprintf(stderr, "%s\n", what);
+	failed = 1;
+}
+
+/** Write contents of a dump */
+static void dump_fill(FILE *f, const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < WRITER_LINES; i++)
+		fprintf(f, "%s line %u\n", name, i);
+}
+
+/** Check file against the contents written by \ref dump_fill */
+static bool dump_check(const char *dir, const char *name)
+{
+	char path[256], line[128], expect[128];
+	unsigned int i;
+	bool ok = true;
+	FILE *f;
+
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+	f = fopen(path, "r");
+	if (!f)
+		return false;
+
+	for (i = 0; ok && i < WRITER_LINES; i++) {
+		snprintf(expect, sizeof(expect), "%s line %u\n", name, i);
+		ok = fgets(line, sizeof(line), f) && strcmp(line, expect) == 0;
+	}
+	ok = ok && fgetc(f) == EOF;
+	fclose(f);
+
+	return ok;
+}
+
+/** Open dump, waiting for a free buffer */
+static FILE *dump_open(struct top_context *ctx, const char *name)
+{
+	uint64_t start = top_time_ms();
+	FILE *f;
+
+	while (!(f = writer_open(ctx, name)) && errno == EBUSY &&
+	       top_time_ms() - start < WRITER_WAIT_MS)
+		usleep(1000);
+
+	return f;
+}
+
+/** Wait for the status of a dump
+
+   \return true if the writer reported the status
+*/
+static bool status_wait(struct top_context *ctx, const char *fmt,
+			const char *dir, const char *name)
+{
+	char status[512], path[256], expect[512];
+	uint64_t start = top_time_ms();
+
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+	snprintf(expect, sizeof(expect), fmt, path);
+
+	do {
+		if (writer_status_get(ctx, status, sizeof(status)) &&
+		    strcmp(status, expect) == 0)
+			return true;
+		usleep(1000);
+	} while (top_time_ms() - start < WRITER_WAIT_MS);
+
+	return false;
+}
+
+static void busy_check(struct top_context *ctx, const char *root)
+{
+	char status[512];
+	FILE *f[2];
+
+	/* both buffers are filled, neither is queued */
+	f[0] = writer_open(ctx, "first");
+	f[1] = writer_open(ctx, "second");
+	check(f[0] && f[1], "can't open two dumps");
+
+	errno = 0;
+	check(!writer_open(ctx, "third") && errno == EBUSY,
+	      "third dump not refused");
+	check(writer_status_get(ctx, status, sizeof(status)) &&
+	      strncmp(status, "Dump writer busy", 16) == 0,
+	      "busy writer not reported");
+
+	if (f[0]) {
+		dump_fill(f[0], "first");
+		writer_queue(ctx, f[0]);
+	}
+	if (f[1]) {
+		dump_fill(f[1], "second");
+		writer_queue(ctx, f[1]);
+	}
+
+	check(status_wait(ctx, "Saved to '%s'", root, "second"),
+	      "busy dumps not saved");
+}
+
+static void queue_check(struct top_context *ctx, const char *root)
+{
+	char name[64];
+	unsigned int i, k;
+	FILE *f;
+
+	for (k = 0; k < ARRAY_SIZE(policy); k++) {
+		top_dump_fsync_set(ctx, policy[k]);
+
+		for (i = 0; i < WRITER_DUMPS; i++) {
+			snprintf(name, sizeof(name), "dump%u_%u", k, i);
+			f = dump_open(ctx, name);
+			if (!f) {
+				check(false, "no free dump buffer");
+				continue;
+			}
+
+			dump_fill(f, name);
+			writer_queue(ctx, f);
+		}
+
+		/* the flush of the policy succeeded */
+		check(status_wait(ctx, "Saved to '%s'", root, name),
+		      "dumps of a flush policy not saved");
+	}
+}
+
+static void error_check(struct top_context *ctx, const char *root)
+{
+	char missing[128];
+	FILE *f;
+
+	/* the stream is in memory, the file can't be created */
+	snprintf(missing, sizeof(missing), "%s/missing", root);
+	top_dump_dir_set(ctx, missing);
+
+	f = dump_open(ctx, "lost");
+	check(f != NULL, "no dump buffer");
+	if (f) {
+		dump_fill(f, "lost");
+		writer_queue(ctx, f);
+	}
+
+	check(status_wait(ctx, "Can't save counters to '%s'", missing, "lost"),
+	      "write error not reported");
+
+	top_dump_dir_set(ctx, root);
+}
+
+static void direct_check(struct top_context *ctx, const char *root)
+{
+	FILE *f;
+
+	/* the directory of a direct dump isn't known */
+	top_dump_fsync_set(ctx, TOP_FSYNC_DIR);
+
+	f = writer_open(ctx, "direct");
+	check(f != NULL, "can't open direct dump");
+	if (!f)
+		return;
+
+	dump_fill(f, "direct");
+	writer_queue(ctx, f);
+
+	check(dump_check(root, "direct"), "direct dump not written");
+}
+
+int main(void)
+{
+	static struct top_context ctx;
+	char root[64], name[64];
+	unsigned int i, k;
+	FILE *f;
+
+	if (procgen_root_create(root, sizeof(root)))
+		return 1;
+
+	if (top_init(&ctx, &record_top_ops, -1, page, ARRAY_SIZE(page), NULL,
+		     0, 100, NULL, NULL, &rec) ||
+	    writer_init(&ctx)) {
+		procgen_root_remove(root);
+		return 1;
+	}
+
+	top_dump_dir_set(&ctx, root);
+
+	busy_check(&ctx, root);
+	error_check(&ctx, root);
+	queue_check(&ctx, root);
+
+	/* pending dumps are written before the thread ends */
+	for (i = 0; i < 2; i++) {
+		snprintf(name, sizeof(name), "pending%u", i);
+		f = dump_open(&ctx, name);
+		if (f) {
+			dump_fill(f, name);
+			writer_queue(&ctx, f);
+		}
+	}
+	writer_shutdown(&ctx);
+
+	check(dump_check(root, "pending0") && dump_check(root, "pending1"),
+	      "pending dumps not written");
+
+	check(dump_check(root, "first") && dump_check(root, "second"),
+	      "busy dumps differ");
+	for (k = 0; k < ARRAY_SIZE(policy); k++) {
+		for (i = 0; i < WRITER_DUMPS; i++) {
+			snprintf(name, sizeof(name), "dump%u_%u", k, i);
+			if (dump_check(root, name))
+				continue;
+
+			fprintf(stderr, "%s differs\n", name);
+			failed = 1;
+		}
+	}
+
+	direct_check(&ctx, root);
+
+	top_shutdown(&ctx);
+	procgen_root_remove(root);
+
+	return failed;
+}